@@ -10,7 +10,7 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 TARGET = 472_ai_project
 TEMPLATE = app
-QMAKE_CXXFLAGS += -std=c++11
+QMAKE_CXXFLAGS += -std=c++14
 
 # The following define makes your compiler emit warnings if you use
 # any feature of Qt which has been marked as deprecated (the exact warnings
@@ -24,22 +24,20 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 
+include(engine/engine.pri)
+
 SOURCES += \
         main.cpp \
         mainwindow.cpp \
-        board.cpp \
-        game.cpp \
-        player.cpp \
-    ai.cpp \
-    integer.cpp
+    aiworker.cpp \
+    searchtreemodel.cpp \
+    engineprocess.cpp
 
 HEADERS += \
         mainwindow.h \
-        board.h \
-        game.h \
-        player.h \
-    ai.h \
-    integer.h
+    aiworker.h \
+    searchtreemodel.h \
+    engineprocess.h
 
 FORMS += \
         mainwindow.ui
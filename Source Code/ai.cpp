@@ -1,410 +1,1109 @@
 #include "ai.h"
-#include <QDebug>
-
-AIPlayer::AIPlayer(Board *current_board) : board(current_board)
+#include "movetables.h"
+#include "zobrist.h"
+#include "notation.h"
+
+AIPlayer::AIPlayer(Board *current_board) : board(current_board), tracing(true),
+    transpositionTable(make_shared<TranspositionTable>()),
+    moveOrdering(true), tablebaseHits(0), bookRandom(OPENING_BOOK_SEED), searchVariant(0), timeLimited(false), searchAborted(false), nodeCount(0),
+    quiescenceNodes(0), leafEvaluations(0), quiescenceSearch(true), nodeLimit(0), completedDepth(0), completedScore(0),
+    principalVariationSearch(true), researches(0),
+    threadCount(1), helperId(0), stopHelpers(false), stopSignal(&stopHelpers), stopRequested(false), totalNodes(0), totalQuiescenceNodes(0),
+    totalLeafEvaluations(0), totalTablebaseHits(0), tracePeakBytes(0), pondering(false), ponderId(0), ponderCancelled(0), ponderHit(false)
 {
-    tree = new QTreeWidget();
+    searchStats.iterations.reserve(MAX_PLY);
+    principalVariation.reserve(MAX_PLY);
 }
 
-vector<vector<vector<char>>> AIPlayer::getFrontierStates(vector<vector<char> > state, char currentPlayer){
-
-    vector<vector<vector<char>>> possible_states = {};
-    
-    // iterate across the matrix to find all AI tokens and
-    // calculate frontier states depending on the available
-    // moves of each token
-    for (int i=0; i < board->getWidth(); i++){
-        for(int j=0; j < board->getHeight(); j++){
-            if (state[i][j] == currentPlayer){
-
-                // temporary board object where we perform
-                // move checking and attacks in order to retrieve
-                // frontier states
-                Board* temporary_board = new Board(state);
-
-                vector<vector<int> > valid_adjancent_tiles = temporary_board->getEmptyAdjacentValidTiles(i,j);
-                if (valid_adjancent_tiles.size() != 0){
-
-                    //iterate over all valid adjacent tiles
-                    for (auto valid_move : valid_adjancent_tiles) {
-
-                        if (temporary_board->checkMove(i,j,valid_move[0],valid_move[1])){
-                            Integer* tempInt = new Integer(0);
-                            temporary_board->performAttack(i, j, valid_move[0], valid_move[1], tempInt, tempInt, tempInt, tempInt, tempInt);
-
-                            // if an attack is performed, the resulting matrix is stored
-                            // in the frontier states
-                            possible_states.push_back(temporary_board->getMatrix());
-
-                            // in order to proceed with the rest of the valid adjacent
-                            // tiles, the temporary board must be reset to the current
-                            // state
-                            delete temporary_board;
-                            temporary_board = new Board(state);
-                        }
-
-                    }
-                }
-                delete temporary_board;
-            }
-        }
-    }
-
-    return possible_states;
+/**
+ * @brief AIPlayer::AIPlayer, helper of a multi-threaded search, shares the table
+ *        and stop signal of the main search and keeps no search tree
+ */
+
+AIPlayer::AIPlayer(AIPlayer* mainPlayer, int id) : board(mainPlayer->board), tracing(false),
+    transpositionTable(mainPlayer->transpositionTable), moveOrdering(mainPlayer->moveOrdering),
+    tablebase(mainPlayer->tablebase), tablebaseHits(0), bookRandom(0), searchVariant(0),
+    timeLimited(false), searchAborted(false), nodeCount(0),
+    quiescenceNodes(0), leafEvaluations(0), quiescenceSearch(mainPlayer->quiescenceSearch), nodeLimit(0), completedDepth(0), completedScore(0),
+    principalVariationSearch(mainPlayer->principalVariationSearch), researches(0),
+    threadCount(1), helperId(id), stopHelpers(false), stopSignal(&mainPlayer->stopHelpers), stopRequested(false), totalNodes(0), totalQuiescenceNodes(0),
+    totalLeafEvaluations(0), totalTablebaseHits(0), tracePeakBytes(0), pondering(false), ponderId(0), ponderCancelled(0), ponderHit(false)
+{
+    // the helpers extend their line from the table as well, once set up they allocate nothing either
+    principalVariation.reserve(MAX_PLY);
+    moveOrderer.setPerturbation(id);
 }
 
-int AIPlayer::naiveHeuristic(vector<vector<char> > state){
-    // naive heuristic function described in
-    // the project section of the moodle page
-    const int WIDTH = board->getWidth();
-    const int HEIGHT = board->getHeight();
-
-    int h_green_sum=0, h_red_sum=0, v_green_sum=0, v_red_sum=0;
-
-    for (int i = 0; i < WIDTH; i++){
-        for (int j = 0; j < HEIGHT; j++){
-            if (state[i][j] == 'G'){
-                h_green_sum += i+1;
-                v_green_sum += j+1;
-            }
-            else if (state[i][j] == 'R'){
-                h_red_sum += i+1;
-                v_red_sum += j+1;
-            }
-        }
-    }
-
-    return 100*v_green_sum+50*h_green_sum-100*v_red_sum-50*h_red_sum;
+AIPlayer::~AIPlayer()
+{
 }
 
-int AIPlayer::countingHeuristic(vector<vector<char> > state){
-    const int WIDTH = board->getWidth();
-    const int HEIGHT = board->getHeight();
-
-    int greenCtr = 0, redCtr = 0;
-
-    for (int i = 0; i < WIDTH; i++){
-        for (int j = 0; j < HEIGHT; j++){
-            if (state[i][j] == 'G')
-                greenCtr++;
-            else if (state[i][j] == 'R')
-                redCtr++;
-        }
-    }
-
-    return greenCtr - redCtr;
+// Search tree display, helper threads search without one
+int AIPlayer::traceChild(int node, const Move& move) {
+    return node >= 0 ? iterationTrace->addChild(node, move) : -1;
 }
 
-int AIPlayer::informedHeuristic(vector<vector<char>> previousState, vector<vector<char> > state, char currentPlayer){
-    const int WIDTH = board->getWidth();
-    const int HEIGHT = board->getHeight();
-
-    int greenCtr = 0, redCtr = 0;
-
-    for (int i = 0; i < WIDTH; i++){
-        for (int j = 0; j < HEIGHT; j++){
-            if (state[i][j] == 'G') {
-                if (board->getTileColor(i, j))
-                    greenCtr += 100;
-                else
-                    greenCtr += 50;
-            }
-            else if (state[i][j] == 'R') {
-                if (board->getTileColor(i, j))
-                    redCtr += 100;
-                else
-                    redCtr += 50;
-            }
-        }
-    }
-
-    int heuristicValue = greenCtr - redCtr;
-
-    char opponentPlayer;
-
-    if (currentPlayer == 'G')
-        opponentPlayer = 'R';
-    else
-        opponentPlayer = 'G';
+void AIPlayer::traceValue(int node, int value) {
+    if (node >= 0)
+        iterationTrace->setScore(node, value);
+}
 
-    vector<vector<int>> move = nextMove(previousState, state, opponentPlayer);
+/**
+ * @brief AIPlayer::updatePrincipalVariation, the move became the best of its node,
+ *        its line is the move followed by the line of the child it leads to
+ * @param ply, plies from the root to the node
+ */
 
-    int x = move[1][0];
-    int y = move[1][1];
+void AIPlayer::updatePrincipalVariation(int ply, const Move& move) {
+    pvLine[ply][ply] = move;
 
-    int defensiveValue = board->getTokenStreak(x, y, currentPlayer, state);
-    int offensiveValue = board->getTokenStreak(x, y, opponentPlayer, state);
+    for (int i = ply + 1; i < pvLength[ply + 1]; i++)
+        pvLine[ply][i] = pvLine[ply + 1][i];
 
-    if (currentPlayer == 'G') {
-        heuristicValue -= (5 * defensiveValue);
-        heuristicValue += (10 * offensiveValue);
-    }
-    else {
-        heuristicValue += (5 * defensiveValue);
-        heuristicValue -= (10 * offensiveValue);
-    }
-
-    return heuristicValue;
+    pvLength[ply] = max(pvLength[ply + 1], ply + 1);
 }
 
-int AIPlayer::minimax(vector<vector<char>> previousState, vector<vector<char>> state, char currentPlayer, int level, int depth, bool min_level, int heuristicIndex, QTreeWidgetItem *root){
-    if (root == nullptr) {
-        root = new QTreeWidgetItem();
-        tree->clear();
-        tree->addTopLevelItem(root);
-    }
+template<class Evaluator>
+int AIPlayer::minimax(char currentPlayer, int level, int depth, bool min_level, int node){
+    int ply = depth - level;
+    pvLength[ply] = ply;
+
+    if (isTimeUp())
+        return 0;
 
     // if level is zero, then return the heuristic
     // value given by the heuristic function
     if (level == 1) {
-        int tempValue;
+        // the side that just moved into this position
+        char previousPlayer = currentPlayer == 'G' ? 'R' : 'G';
+        int tempValue = Evaluator::evaluate(position, previousPlayer);
+        leafEvaluations++;
 
-        switch(heuristicIndex) {
-        case 0:
-            tempValue = naiveHeuristic(state);
-            break;
-        case 1:
-            tempValue = countingHeuristic(state);
-            break;
-        case 2:
-            tempValue = informedHeuristic(previousState, state, currentPlayer);
-            break;
-        }
-
-        root->setText(0, QString::number(tempValue));
+        traceValue(node, tempValue);
         return tempValue;
     }
 
     //if level is not zero, recursively call
-    // minimax() on all frontier states
+    // minimax() on all frontier states, playing and
+    // taking back each move on the search position
     else {
-        vector<vector<vector<char> > > current_level_states = getFrontierStates(state, currentPlayer);
+        int remaining = level - 1;
+        uint64_t key = getSearchKey(currentPlayer, Evaluator::INDEX);
+        TTEntry entry;
+
+        // an exact score searched at least as deep settles the node,
+        // the root is always searched so every child gets a value
+        if (level != depth && transpositionTable->probe(key, entry, hashCounters)
+                && entry.depth >= remaining && entry.getBound() == BOUND_EXACT) {
+            traceValue(node, entry.score);
+            return entry.score;
+        }
+
+        char nextPlayer = currentPlayer == 'G' ? 'R' : 'G';
+        Move moves[MAX_MOVES];
+        int moveCount = position.generateMoves(currentPlayer, moves);
+        int bestIndex = -1;
+
+        if (node >= 0)
+            iterationTrace->expand(node, moveCount);
 
         // call getHeuristic on first element of frontier states
         // to perform the initial comparison
         int return_heuristic = min_level ? -999999 : 999999;
-        QTreeWidgetItem *leaf;
+        int leaf;
 
         // compare each state and determine greatest or
         // smallest heuristic depending on whether level
         // is min or max
-        for (auto currentState : current_level_states) {
-            leaf = new QTreeWidgetItem(root);
-            int current_state_heuristic = minimax(state, currentState, currentPlayer, level-1, depth, !min_level, heuristicIndex, leaf);
+        for (int i = 0; i < moveCount; i++) {
+            leaf = traceChild(node, moves[i]);
+            position.makeMove(moves[i]);
+            int current_state_heuristic = minimax<Evaluator>(nextPlayer, level-1, depth, !min_level, leaf);
+            position.unmakeMove();
 
-            if (level == depth)
-                frontierValues.push_back(current_state_heuristic);
+            // an unfinished subtree has no value, leave it out of the table
+            if (searchAborted)
+                return 0;
 
             if (min_level){
+                if (bestIndex < 0 || current_state_heuristic > return_heuristic) {
+                    bestIndex = i;
+                    updatePrincipalVariation(ply, moves[i]);
+                }
                 return_heuristic = return_heuristic > current_state_heuristic ? return_heuristic : current_state_heuristic;
             }
             else {
+                if (bestIndex < 0 || current_state_heuristic < return_heuristic) {
+                    bestIndex = i;
+                    updatePrincipalVariation(ply, moves[i]);
+                }
                 return_heuristic = return_heuristic < current_state_heuristic ? return_heuristic : current_state_heuristic;
             }
         }
 
-        root->setText(0, QString::number(return_heuristic));
+        if (level == depth && bestIndex >= 0)
+            rootBestMove = moves[bestIndex];
+
+        transpositionTable->store(key, remaining, return_heuristic, BOUND_EXACT, bestIndex >= 0 ? &moves[bestIndex] : nullptr, hashCounters);
+
+        traceValue(node, return_heuristic);
 
         return return_heuristic;
     }
 }
 
-int AIPlayer::alphabeta(vector<vector<char>> previousState, vector<vector<char>> state, char currentPlayer, int level, int depth, int alpha, int beta, bool min_level, int heuristicIndex, QTreeWidgetItem *root){
-    if (root == nullptr) {
-        root = new QTreeWidgetItem();
-        tree->clear();
-        tree->addTopLevelItem(root);
+template<class Evaluator>
+int AIPlayer::alphabeta(char currentPlayer, int level, int depth, int alpha, int beta, bool min_level, int node){
+    int ply = depth - level;
+    pvLength[ply] = ply;
+
+    if (isTimeUp())
+        return 0;
+
+    // the endgame tables know the result, closer wins score higher
+    TablebaseEntry tablebaseEntry;
+
+    if (tablebase && level != depth && tablebase->probe(position, currentPlayer, tablebaseEntry)) {
+        int score = tablebaseScore(tablebaseEntry, currentPlayer);
+        tablebaseHits++;
+        traceValue(node, score);
+        return score;
     }
 
     if (level == 1) {
+        // the side that just moved into this position
+        char previousPlayer = currentPlayer == 'G' ? 'R' : 'G';
         int tempValue;
 
-        switch(heuristicIndex) {
-        case 0:
-            tempValue = naiveHeuristic(state);
-            break;
-        case 1:
-            tempValue = countingHeuristic(state);
-            break;
-        case 2:
-            tempValue = informedHeuristic(previousState, state, currentPlayer);
-            break;
+        if (quiescenceSearch)
+            tempValue = quiescence<Evaluator>(currentPlayer, alpha, beta, min_level, 0);
+        else {
+            tempValue = Evaluator::evaluate(position, previousPlayer);
+            leafEvaluations++;
         }
 
-        root->setText(0, QString::number(tempValue));
+        if (searchAborted)
+            return 0;
+
+        traceValue(node, tempValue);
         return tempValue;
     }
     else {
-        QTreeWidgetItem *leaf;
-        vector<vector<vector<char>>> current_level_states = getFrontierStates(state, currentPlayer);
+        int remaining = level - 1;
+        uint64_t key = getSearchKey(currentPlayer, Evaluator::INDEX);
+        TTEntry entry;
+
+        bool found = transpositionTable->probe(key, entry, hashCounters);
+
+        // a stored result searched at least as deep can cut the node off:
+        // exact scores always, bounds when they fall outside the window
+        if (level != depth && found && entry.depth >= remaining) {
+            if (entry.getBound() == BOUND_EXACT
+                    || (entry.getBound() == BOUND_LOWER && entry.score >= beta)
+                    || (entry.getBound() == BOUND_UPPER && entry.score <= alpha)) {
+                traceValue(node, entry.score);
+                return entry.score;
+            }
+        }
+
+        int leaf;
+        char nextPlayer = currentPlayer == 'G' ? 'R' : 'G';
+        Move moves[MAX_MOVES];
+        int moveCount = position.generateMoves(currentPlayer, moves);
+        int scores[MAX_MOVES];
+        int alphaOriginal = alpha;
+        int betaOriginal = beta;
+        int bestIndex = -1;
+
+        if (node >= 0)
+            iterationTrace->expand(node, moveCount);
+
+        // the best move stored for the position, even by a shallower search, is tried first;
+        // the root starts with the move of the last iteration and leaves the killers and
+        // history out, so which of two equal moves is played only depends on the position
+        if (moveOrdering && level == depth) {
+            bool iterated = !principalVariation.empty();
+            moveOrderer.scoreRootMoves(moves, scores, moveCount, iterated ? principalVariation[0].from : -1,
+                                       iterated ? principalVariation[0].to : -1);
+        }
+        else if (moveOrdering)
+            moveOrderer.scoreMoves(moves, scores, moveCount, ply, found ? entry.bestFrom : -1, found ? entry.bestTo : -1);
 
         if (min_level) {
             int return_heuristic = 999999;
 
-            for (auto currentState: current_level_states) {
-                leaf = new QTreeWidgetItem(root);
-                int tempHeuristic = alphabeta(state, currentState, currentPlayer, level - 1, depth, alpha, beta, !min_level, heuristicIndex, leaf);
+            for (int i = 0; i < moveCount; i++) {
+                if (moveOrdering)
+                    moveOrderer.pickMove(moves, scores, i, moveCount);
+
+                leaf = traceChild(node, moves[i]);
+                position.makeMove(moves[i]);
+                int tempHeuristic;
+
+                // the first move is searched with the full window, the others only have
+                // to prove they are no lower with a null window at beta, and are searched
+                // again with the full window when one turns out lower after all
+                if (i == 0 || !principalVariationSearch)
+                    tempHeuristic = alphabeta<Evaluator>(nextPlayer, level - 1, depth, alpha, beta, !min_level, leaf);
+                else {
+                    tempHeuristic = alphabeta<Evaluator>(nextPlayer, level - 1, depth, beta - 1, beta, !min_level, leaf);
+
+                    if (!searchAborted && tempHeuristic > alpha && tempHeuristic < beta) {
+                        researches++;
+                        tempHeuristic = alphabeta<Evaluator>(nextPlayer, level - 1, depth, alpha, beta, !min_level, leaf);
+                    }
+                }
+
+                position.unmakeMove();
+
+                if (searchAborted)
+                    return 0;
+
+                if (bestIndex < 0 || tempHeuristic < return_heuristic) {
+                    bestIndex = i;
+                    updatePrincipalVariation(ply, moves[i]);
+                }
+
                 return_heuristic = min(return_heuristic, tempHeuristic);
                 beta = min(beta, return_heuristic);
 
-                if (beta <= alpha)
+                if (beta <= alpha) {
+                    moveOrderer.addCutoff(moves[i], ply, remaining, i);
                     break;
+                }
             }
 
-            root->setText(0, QString::number(return_heuristic));
+            if (level == depth && bestIndex >= 0)
+                rootBestMove = moves[bestIndex];
+
+            storeResult(key, remaining, return_heuristic, alphaOriginal, betaOriginal, bestIndex >= 0 ? &moves[bestIndex] : nullptr);
+            traceValue(node, return_heuristic);
 
             return return_heuristic;
         }
         else {
             int return_heuristic = -999999;
 
-            for (auto currentState: current_level_states) {
-                leaf = new QTreeWidgetItem(root);
-                int tempHeuristic = alphabeta(state, currentState, currentPlayer, level - 1, depth, alpha, beta, !min_level, heuristicIndex, leaf);
+            for (int i = 0; i < moveCount; i++) {
+                if (moveOrdering)
+                    moveOrderer.pickMove(moves, scores, i, moveCount);
+
+                leaf = traceChild(node, moves[i]);
+                position.makeMove(moves[i]);
+                int tempHeuristic;
+
+                // null window at alpha for all but the first move, as above
+                if (i == 0 || !principalVariationSearch)
+                    tempHeuristic = alphabeta<Evaluator>(nextPlayer, level - 1, depth, alpha, beta, !min_level, leaf);
+                else {
+                    tempHeuristic = alphabeta<Evaluator>(nextPlayer, level - 1, depth, alpha, alpha + 1, !min_level, leaf);
+
+                    if (!searchAborted && tempHeuristic > alpha && tempHeuristic < beta) {
+                        researches++;
+                        tempHeuristic = alphabeta<Evaluator>(nextPlayer, level - 1, depth, alpha, beta, !min_level, leaf);
+                    }
+                }
+
+                position.unmakeMove();
+
+                if (searchAborted)
+                    return 0;
+
+                if (bestIndex < 0 || tempHeuristic > return_heuristic) {
+                    bestIndex = i;
+                    updatePrincipalVariation(ply, moves[i]);
+                }
+
                 return_heuristic = max(return_heuristic, tempHeuristic);
                 alpha = max(alpha, return_heuristic);
 
-                if (beta <= alpha)
+                if (beta <= alpha) {
+                    moveOrderer.addCutoff(moves[i], ply, remaining, i);
                     break;
+                }
             }
 
-            root->setText(0, QString::number(return_heuristic));
+            if (level == depth && bestIndex >= 0)
+                rootBestMove = moves[bestIndex];
+
+            storeResult(key, remaining, return_heuristic, alphaOriginal, betaOriginal, bestIndex >= 0 ? &moves[bestIndex] : nullptr);
+            traceValue(node, return_heuristic);
 
             return return_heuristic;
         }
     }
 }
 
-vector<vector<int>> AIPlayer::nextMove(vector<vector<char>> state_original, vector<vector<char>> state_new, char opponentPlayer){
-    vector<int> originPos;
-    vector<int> destPos;
-    vector<vector<int>> nextMove;
-
-    const int WIDTH = board->getWidth();
-    const int HEIGHT = board->getHeight();
-
-    bool searchOver = false;
-
-    // Iterate through the two states in order to find the token that moved
-    for (int x = 0; x < WIDTH; ++x)
-    {
-        for (int y = 0; y < HEIGHT; ++y)
-        {
-            // If at (x,y) on both state doesn't match, that means a token moved from/to there
-            if (state_original[x][y] != state_new[x][y])
-            {
-				// If the token at (x,y) is not the ai token in either states, continue to search (For now, R = AI token, G = Player Token)
-                if (state_original[x][y] == opponentPlayer || state_new[x][y] == opponentPlayer)
-					continue;
-				
-                // If on the original state we get a 'X' at (x,y), the token will move to that (x,y)
-                if (state_original[x][y] == 'X')
-                {
-                    destPos.push_back(x);
-                    destPos.push_back(y);
-                }
+/**
+ * @brief AIPlayer::quiescence, plays out the captures at a leaf of alpha-beta so the leaf
+ *        is not scored halfway through an exchange; the side to move may stand pat on the
+ *        static score, a capture that cannot bring the score back into the window is
+ *        skipped (delta pruning) and no more than QUIESCENCE_PLIES captures are played
+ * @param currentPlayer, the side to move
+ * @param min_level, red to move, it looks for the lowest score
+ * @param qply, captures played since the leaf, 0 at the leaf itself
+ */
+
+template<class Evaluator>
+int AIPlayer::quiescence(char currentPlayer, int alpha, int beta, bool min_level, int qply){
+    char previousPlayer = currentPlayer == 'G' ? 'R' : 'G';
+    int standPat = Evaluator::evaluate(position, previousPlayer);
+    leafEvaluations++;
+
+    // a side without tokens has lost, there is no exchange left to resolve
+    if (qply >= QUIESCENCE_PLIES || position.getUndoCount() >= MAX_PLY
+            || position.getTokenAmount('R') == 0 || position.getTokenAmount('G') == 0)
+        return standPat;
+
+    if (min_level) {
+        if (standPat <= alpha)
+            return standPat;
+        beta = min(beta, standPat);
+    }
+    else {
+        if (standPat >= beta)
+            return standPat;
+        alpha = max(alpha, standPat);
+    }
 
-                // If on the new state we get a 'X' at (x,y), the token was originally at that (x,y)
-                if (state_new[x][y] == 'X')
-                {
-                    originPos.push_back(x);
-                    originPos.push_back(y);
-                }
+    Move moves[MAX_MOVES];
+    int scores[MAX_MOVES];
+    int moveCount = position.generateMoves(currentPlayer, moves);
+    int best = standPat;
 
-                // If the search has found both coordinates, stop all loops
-                if (originPos.size() == 2 && destPos.size() == 2)
-                {
-                    searchOver = true;
-                    nextMove.push_back(originPos);
-                    nextMove.push_back(destPos);
-                    break;
-                }
-            }
+    // the biggest captures first
+    for (int i = 0; i < moveCount; i++)
+        scores[i] = moves[i].captureCount;
+
+    for (int i = 0; i < moveCount; i++) {
+        moveOrderer.pickMove(moves, scores, i, moveCount);
+
+        // quiet moves are left out, and sorted last
+        if (moves[i].captureCount == 0)
+            break;
+
+        int gain = Evaluator::captureGain(moves[i]);
+
+        if (min_level ? standPat - gain >= beta : standPat + gain <= alpha)
+            continue;
+
+        quiescenceNodes++;
+
+        if (isTimeUp())
+            return 0;
+
+        position.makeMove(moves[i]);
+        int score = quiescence<Evaluator>(previousPlayer, alpha, beta, !min_level, qply + 1);
+        position.unmakeMove();
+
+        if (searchAborted)
+            return 0;
+
+        if (min_level) {
+            best = min(best, score);
+            beta = min(beta, best);
+        }
+        else {
+            best = max(best, score);
+            alpha = max(alpha, best);
         }
 
-        // Stop the loop, search is over
-        if (searchOver)
+        if (beta <= alpha)
             break;
     }
 
-    return nextMove;
+    return best;
 }
 
-vector<vector<int> > AIPlayer::getNextMoveFromAI(int level, char currentPlayer, bool isMiniMax, int heuristicIndex) {
-    // vector of frontier states of current state of the game board
-    vector<vector<vector<char> > > frontier_states;
+/**
+ * @brief AIPlayer::setSearchVariant, keys the table entries of the coming search by its
+ *        algorithm and, for alpha-beta, by its capture search; the table is kept between
+ *        moves and the scores of the same position differ between them
+ * @param isMiniMax, minimax or alpha-beta
+ */
+
+void AIPlayer::setSearchVariant(bool isMiniMax) {
+    if (isMiniMax)
+        searchVariant = ZOBRIST_KEYS.minimax;
+    else
+        searchVariant = quiescenceSearch ? ZOBRIST_KEYS.quiescence : 0;
+}
 
-    int best_heuristic, best_heuristic_index = 0;
+/**
+ * @brief AIPlayer::getSearchKey, transposition table key of the search position
+ *        with currentPlayer to move, scored with the given heuristic by the
+ *        search set by setSearchVariant
+ */
 
-    frontier_states = getFrontierStates(board->getMatrix(), currentPlayer);
+uint64_t AIPlayer::getSearchKey(char currentPlayer, int heuristicIndex) {
+    uint64_t key = position.getHash() ^ ZOBRIST_KEYS.heuristic[heuristicIndex] ^ searchVariant;
 
-    char opponentPlayer;
+    if (currentPlayer == 'R')
+        key ^= ZOBRIST_KEYS.redToMove;
 
-    if (currentPlayer == 'G')
-        opponentPlayer = 'R';
-    else
-        opponentPlayer = 'G';
+    return key;
+}
 
-    if (isMiniMax) {
-        if (currentPlayer == 'R')
-            best_heuristic = minimax(board->getMatrix(), board->getMatrix(), currentPlayer, level, level, false, heuristicIndex, nullptr);
-        else
-            best_heuristic = minimax(board->getMatrix(), board->getMatrix(), currentPlayer, level, level, true, heuristicIndex, nullptr);
+/**
+ * @brief AIPlayer::storeResult, saves an alpha-beta result with the bound its window gives it
+ */
+
+void AIPlayer::storeResult(uint64_t key, int remaining, int score, int alphaOriginal, int betaOriginal, const Move* best) {
+    BoundType bound = BOUND_EXACT;
+
+    if (score <= alphaOriginal)
+        bound = BOUND_UPPER;
+    else if (score >= betaOriginal)
+        bound = BOUND_LOWER;
+
+    transpositionTable->store(key, remaining, score, bound, best, hashCounters);
+}
+
+/**
+ * @brief AIPlayer::isTimeUp, tells the search to unwind once the move's time budget is spent
+ */
+
+bool AIPlayer::isTimeUp() {
+    nodeCount++;
+
+    // helpers stop as soon as the main search is done, the main
+    // search when asked to or out of nodes once it has a move to
+    // play, a ponder as soon as the opponent has moved
+    if (helperId != 0 && stopSignal->load(memory_order_relaxed))
+        searchAborted = true;
+    else if (pondering && ponderCancelled.load(memory_order_relaxed) >= ponderId)
+        searchAborted = true;
+    else if (helperId == 0 && !pondering && completedDepth > 0
+             && (stopRequested.load(memory_order_relaxed) || (nodeLimit != 0 && nodeCount >= nodeLimit)))
+        searchAborted = true;
+
+    if (!searchAborted && timeLimited && (nodeCount & 1023) == 0)
+        searchAborted = chrono::steady_clock::now() >= deadline;
+
+    return searchAborted;
+}
+
+/**
+ * @brief AIPlayer::getNextMoveFromAI, searches the game board for the AI's move,
+ *        with the helper threads of an alpha-beta search running beside it
+ * @param level, deepest search allowed, 1 + the number of plies
+ * @param currentPlayer, the side the AI plays
+ * @param isMiniMax, minimax or alpha-beta
+ * @param heuristicIndex, 0 = naive, 1 = counting, 2 = informed
+ * @param timeLimitMs, wall clock budget in milliseconds, 0 = no limit
+ * @return the best move of the deepest iteration the main search completed
+ */
+
+Move AIPlayer::getNextMoveFromAI(int level, char currentPlayer, bool isMiniMax, int heuristicIndex, int timeLimitMs) {
+    // the search plays and takes back moves on its own
+    // copy of the game board
+    position = board->getPosition();
+    ponderHit = false;
+    searchStart = chrono::steady_clock::now();
+    searchStats.iterations.clear();
+    tracePeakBytes = 0;
+
+    // a position the endgame tables hold is played from them, the
+    // best result is known and there is nothing left to search
+    Move tablebaseMove;
+    TablebaseEntry tablebaseEntry;
+
+    if (tablebase && tablebase->probeRoot(position, currentPlayer, tablebaseMove, tablebaseEntry)) {
+        totalTablebaseHits = 1;
+        playStoredMove(tablebaseMove, tablebaseScore(tablebaseEntry, currentPlayer), currentPlayer, isMiniMax, heuristicIndex);
+        searchStats.algorithm = "tablebase";
+        return tablebaseMove;
     }
-    else {
-        if (currentPlayer == 'R')
-            best_heuristic = alphabeta(board->getMatrix(), board->getMatrix(), currentPlayer, level, level, -999999, 999999, true, heuristicIndex, nullptr);
-        else
-            best_heuristic = alphabeta(board->getMatrix(), board->getMatrix(), currentPlayer, level, level, -999999, 999999, false, heuristicIndex, nullptr);
+
+    // and a position of the opening book from the book, searched far deeper
+    // when the book was made than there is time for now
+    Move bookMove;
+    OpeningBookEntry bookEntry;
+
+    if (openingBook && openingBook->probe(position, currentPlayer, ZobristKeys::splitMix(bookRandom), bookMove, bookEntry)) {
+        totalTablebaseHits = 0;
+        playStoredMove(bookMove, bookEntry.score, currentPlayer, isMiniMax, heuristicIndex);
+        searchStats.algorithm = "book";
+        return bookMove;
     }
 
-    if (isMiniMax) {
-        for (unsigned int i = 0; i < frontierValues.size(); i++) {
-            if (best_heuristic == frontierValues[i]) {
-                best_heuristic_index = i;
-            }
-        }
+    setSearchVariant(isMiniMax);
+    uint64_t key = getSearchKey(currentPlayer, heuristicIndex);
+
+    // the opponent played a move the AI pondered on, its reply is ready
+    for (PonderReply& pondered : ponderReplies) {
+        if (pondered.key != key || pondered.level != level || pondered.isMiniMax != isMiniMax
+                || pondered.heuristicIndex != heuristicIndex)
+            continue;
+
+        searchTrace = pondered.trace;
+
+        Move reply = pondered.reply;
+        completedDepth = pondered.completedDepth;
+        completedScore = pondered.score;
+        totalNodes = pondered.nodes;
+        totalQuiescenceNodes = pondered.quiescenceNodes;
+        totalLeafEvaluations = pondered.leafEvaluations;
+        totalTablebaseHits = pondered.tablebaseHits;
+        principalVariation = pondered.principalVariation;
+        researches = 0;
+        hashCounters = TTCounters();
+        moveOrderer.resetCounters();
+        ponderHit = true;
+
+        clearPonderReplies();
+        collectStats(reply, currentPlayer, isMiniMax, heuristicIndex);
+        return reply;
     }
-    else {
-        for (int i = 0; i < tree->topLevelItem(0)->childCount(); i++) {
-            if (best_heuristic == tree->topLevelItem(0)->child(i)->text(0).toInt()) {
-                best_heuristic_index = i;
+
+    // otherwise the search starts over, on a table warmed by the ponder
+    clearPonderReplies();
+
+    // the search of the heuristic is picked here, its leaves call the evaluator directly
+    Move move = withEvaluator(heuristicIndex, [&](auto evaluator) {
+        return this->searchPosition<decltype(evaluator)>(level, currentPlayer, isMiniMax, timeLimitMs);
+    });
+
+    collectStats(move, currentPlayer, isMiniMax, heuristicIndex);
+    return move;
+}
+
+/**
+ * @brief AIPlayer::playStoredMove, sets up the results of a move taken from the endgame
+ *        tables or the opening book as those of a search that did not need a node,
+ *        the tablebase hits are set by the caller
+ * @param score, of the position after the move, green minus red
+ */
+
+void AIPlayer::playStoredMove(const Move& move, int score, char currentPlayer, bool isMiniMax, int heuristicIndex) {
+    clearPonderReplies();
+    searchTrace.reset();
+    completedDepth = 0;
+    completedScore = score;
+    totalNodes = 0;
+    totalQuiescenceNodes = 0;
+    totalLeafEvaluations = 0;
+    principalVariation.assign(1, move);
+    researches = 0;
+    hashCounters = TTCounters();
+    moveOrderer.resetCounters();
+
+    collectStats(move, currentPlayer, isMiniMax, heuristicIndex);
+}
+
+/**
+ * @brief AIPlayer::collectStats, fills the statistics of the move from the counters
+ *        the search left, its iterations are already recorded
+ * @param move, the move the search chose
+ */
+
+void AIPlayer::collectStats(const Move& move, char currentPlayer, bool isMiniMax, int heuristicIndex) {
+    searchStats.algorithm = isMiniMax ? "minimax" : "alphabeta";
+    searchStats.heuristicIndex = heuristicIndex;
+    searchStats.side = currentPlayer;
+    searchStats.move = moveName(move);
+    searchStats.score = completedScore;
+    searchStats.depth = completedDepth;
+    searchStats.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - searchStart).count();
+    searchStats.ponderHit = ponderHit;
+    searchStats.nodes = totalNodes;
+    searchStats.quiescenceNodes = totalQuiescenceNodes;
+    searchStats.leafEvaluations = totalLeafEvaluations;
+    searchStats.tablebaseHits = totalTablebaseHits;
+    searchStats.cutoffs = moveOrderer.getCutoffs();
+
+    for (int i = 0; i < CUTOFF_SLOTS; i++)
+        searchStats.cutoffsAtMove[i] = moveOrderer.getCutoffsAtMove(i);
+
+    searchStats.hashProbes = hashCounters.probes;
+    searchStats.hashHits = hashCounters.hits;
+    searchStats.researches = researches;
+    searchStats.tracePeakBytes = tracePeakBytes;
+}
+
+/**
+ * @brief AIPlayer::searchPosition, searches the position the search plays on
+ *        for the move of currentPlayer
+ * @return the best move of the deepest iteration the main search completed
+ */
+
+template<class Evaluator>
+Move AIPlayer::searchPosition(int level, char currentPlayer, bool isMiniMax, int timeLimitMs) {
+    // entries of earlier moves stay in the table but are replaced first
+    transpositionTable->newSearch();
+
+    // moves available from the current state of the game board,
+    // in the same order the search visits them
+    Move moves[MAX_MOVES];
+
+    // no move left, the side to move has lost and there is nothing to search
+    if (position.generateMoves(currentPlayer, moves) == 0) {
+        searchTrace.reset();
+        completedDepth = 0;
+        completedScore = currentPlayer == 'G' ? -999999 : 999999;
+        principalVariation.clear();
+        totalNodes = 0;
+        totalQuiescenceNodes = 0;
+        totalLeafEvaluations = 0;
+        totalTablebaseHits = 0;
+        researches = 0;
+        hashCounters = TTCounters();
+        moveOrderer.resetCounters();
+        return NULL_MOVE;
+    }
+
+    // minimax has no cutoffs for the helpers to speed up
+    int helperCount = isMiniMax ? 0 : threadCount - 1;
+    HelperSearch helperSearch = {this, level, moves, currentPlayer, isMiniMax};
+
+    stopHelpers.store(false, memory_order_relaxed);
+
+    for (int i = 0; i < helperCount; i++)
+        helpers[i]->position = position;
+
+    if (helperCount > 0)
+        helperThreads.run(&AIPlayer::runHelper<Evaluator>, &helperSearch);
+
+    Move bestMove = iterativeDeepening<Evaluator>(level, moves, currentPlayer, isMiniMax, timeLimitMs);
+
+    stopHelpers.store(true, memory_order_relaxed);
+    totalNodes = nodeCount;
+    totalQuiescenceNodes = quiescenceNodes;
+    totalLeafEvaluations = leafEvaluations;
+    totalTablebaseHits = tablebaseHits;
+
+    if (helperCount > 0)
+        helperThreads.wait();
+
+    for (int i = 0; i < helperCount; i++) {
+        totalNodes += helpers[i]->nodeCount;
+        totalQuiescenceNodes += helpers[i]->quiescenceNodes;
+        totalLeafEvaluations += helpers[i]->leafEvaluations;
+        totalTablebaseHits += helpers[i]->tablebaseHits;
+        hashCounters += helpers[i]->hashCounters;
+    }
+
+    return bestMove;
+}
+
+/**
+ * @brief AIPlayer::runHelper, the task of a helper thread, searches beside the main search
+ * @param context, the HelperSearch of the main search
+ * @param worker, index of the helper
+ */
+
+template<class Evaluator>
+void AIPlayer::runHelper(void* context, int worker) {
+    const HelperSearch* search = static_cast<const HelperSearch*>(context);
+    AIPlayer* helper = search->mainPlayer->helpers[worker].get();
+
+    helper->iterativeDeepening<Evaluator>(search->level, search->moves, search->currentPlayer, search->isMiniMax, 0);
+}
+
+/**
+ * @brief AIPlayer::extendPrincipalVariation, a line cut short by a table entry or by
+ *        the work of the helpers is continued with the best moves stored in the table
+ * @param currentPlayer, the side to move at the root
+ * @param plies, length of the line the iteration searched
+ */
+
+template<class Evaluator>
+void AIPlayer::extendPrincipalVariation(char currentPlayer, int plies) {
+    char player = currentPlayer;
+    TTCounters counters;
+
+    for (const Move& move : principalVariation) {
+        position.makeMove(move);
+        player = player == 'G' ? 'R' : 'G';
+    }
+
+    while (static_cast<int>(principalVariation.size()) < plies) {
+        TTEntry entry;
+        Move moves[MAX_MOVES];
+        int moveCount = position.generateMoves(player, moves);
+        int found = -1;
+
+        if (!transpositionTable->probe(getSearchKey(player, Evaluator::INDEX), entry, counters))
+            break;
+
+        for (int i = 0; i < moveCount && found < 0; i++)
+            if (moves[i].from == entry.bestFrom && moves[i].to == entry.bestTo)
+                found = i;
+
+        if (found < 0)
+            break;
+
+        principalVariation.push_back(moves[found]);
+        position.makeMove(moves[found]);
+        player = player == 'G' ? 'R' : 'G';
+    }
+
+    for (unsigned int i = 0; i < principalVariation.size(); i++)
+        position.unmakeMove();
+}
+
+/**
+ * @brief AIPlayer::iterativeDeepening, searches 1, 2, 3... plies until the level cap or
+ *        the time budget is reached, every other helper starts one ply deeper
+ * @param moves, the root moves, the fallback when there is nothing to search
+ * @return the best move of the deepest iteration that completed
+ */
+
+template<class Evaluator>
+Move AIPlayer::iterativeDeepening(int level, const Move* moves, char currentPlayer, bool isMiniMax, int timeLimitMs) {
+    setSearchVariant(isMiniMax);
+    hashCounters = TTCounters();
+    moveOrderer.newSearch();
+    moveOrderer.resetCounters();
+
+    // the first iteration is never cut short so there always is a move to play
+    deadline = chrono::steady_clock::now() + chrono::milliseconds(timeLimitMs);
+    timeLimited = false;
+    searchAborted = false;
+    nodeCount = 0;
+    quiescenceNodes = 0;
+    leafEvaluations = 0;
+    tablebaseHits = 0;
+    researches = 0;
+    completedDepth = 0;
+    principalVariation.clear();
+
+    uint64_t iterationNodes = 0;
+    chrono::steady_clock::time_point iterationStart = chrono::steady_clock::now();
+
+    Move bestMove = moves[0];
+
+    // the score swings between odd and even depths with the side that moves
+    // last, so each iteration is compared with the one two plies before it
+    int parityScore[2] = {0, 0};
+    bool parityCompleted[2] = {false, false};
+
+    for (int depth = min(2 + helperId % 2, level); depth <= level; depth++) {
+        // alpha-beta expects the score close to the one of that iteration,
+        // a side of the window the score falls outside of is opened and the
+        // iteration searched again
+        int alpha = -999999;
+        int beta = 999999;
+        int score;
+
+        if (principalVariationSearch && parityCompleted[depth % 2]) {
+            alpha = max(parityScore[depth % 2] - Evaluator::ASPIRATION_WINDOW, -999999);
+            beta = min(parityScore[depth % 2] + Evaluator::ASPIRATION_WINDOW, 999999);
+        }
+
+        while (true) {
+            int root = -1;
+            rootBestMove = moves[0];
+
+            // the trace of the last move may still be displayed, it is set aside
+            // for the spare one then, so the trees keep their memory between moves
+            if (tracing) {
+                if (!iterationTrace || iterationTrace.use_count() > 1) {
+                    iterationTrace.swap(spareTrace);
+
+                    if (!iterationTrace || iterationTrace.use_count() > 1)
+                        iterationTrace = make_shared<SearchTrace>();
+                }
+
+                iterationTrace->clear();
+                root = iterationTrace->addRoot();
+            }
+
+            if (isMiniMax) {
+                score = minimax<Evaluator>(currentPlayer, depth, depth, currentPlayer != 'R', root);
                 break;
             }
+
+            score = alphabeta<Evaluator>(currentPlayer, depth, depth, alpha, beta, currentPlayer == 'R', root);
+
+            if (searchAborted)
+                break;
+
+            if (score <= alpha && alpha != -999999)
+                alpha = -999999;
+            else if (score >= beta && beta != 999999)
+                beta = 999999;
+            else
+                break;
+
+            researches++;
+        }
+
+        // keep the tree and move of the last iteration that finished
+        if (searchAborted)
+            break;
+
+        if (tracing) {
+            tracePeakBytes = max(tracePeakBytes, iterationTrace->getMemoryUsage()
+                                 + (searchTrace ? searchTrace->getMemoryUsage() : 0));
+            searchTrace.swap(iterationTrace);
+        }
+
+        bestMove = rootBestMove;
+        completedDepth = depth - 1;
+        completedScore = score;
+        parityScore[depth % 2] = score;
+        parityCompleted[depth % 2] = true;
+        principalVariation.assign(pvLine[0], pvLine[0] + pvLength[0]);
+        extendPrincipalVariation<Evaluator>(currentPlayer, depth - 1);
+        timeLimited = timeLimitMs > 0;
+
+        if (helperId == 0 && !pondering) {
+            chrono::steady_clock::time_point now = chrono::steady_clock::now();
+            searchStats.iterations.push_back({completedDepth, nodeCount - iterationNodes,
+                                              chrono::duration<double, milli>(now - iterationStart).count()});
+            iterationNodes = nodeCount;
+            iterationStart = now;
+
+            if (iterationCallback)
+                iterationCallback(completedDepth, completedScore, nodeCount, bestMove);
+
+            if (nodeLimit != 0 && nodeCount >= nodeLimit)
+                break;
         }
+
+        if (timeLimited && chrono::steady_clock::now() >= deadline)
+            break;
     }
 
-    frontierValues.clear();
+    return bestMove;
+}
 
-    return nextMove(board->getMatrix(), frontier_states[best_heuristic_index], opponentPlayer);
+/**
+ * @brief AIPlayer::ponder, searches on the opponent's time, the opponent's moves are
+ *        ranked by a shallow search and the AI's reply to the best few is searched
+ *        to the level cap, filling the transposition table on the way
+ * @param start, the game board after the AI's move, a copy since the opponent may move
+ *        on it while the ponder runs
+ * @param level, deepest search allowed for the replies, 1 + the number of plies
+ * @param currentPlayer, the side the AI plays, the opponent is to move
+ * @param isMiniMax, minimax or alpha-beta
+ * @param heuristicIndex, 0 = naive, 1 = counting, 2 = informed
+ * @param id, identifies the ponder to stopPondering
+ */
+
+void AIPlayer::ponder(const Position& start, int level, char currentPlayer, bool isMiniMax, int heuristicIndex, int id) {
+    withEvaluator(heuristicIndex, [&](auto evaluator) {
+        this->ponderPosition<decltype(evaluator)>(start, level, currentPlayer, isMiniMax, id);
+    });
 }
 
-void AIPlayer::setTree(QTreeWidget* uiTree) {
-    QTreeWidgetItem* item = new QTreeWidgetItem();
-    item->setText(0, tree->topLevelItem(0)->text(0));
+/**
+ * @brief AIPlayer::ponderPosition, the ponder with the evaluator of its heuristic
+ */
+
+template<class Evaluator>
+void AIPlayer::ponderPosition(const Position& start, int level, char currentPlayer, bool isMiniMax, int id) {
+    char opponent = currentPlayer == 'G' ? 'R' : 'G';
+
+    clearPonderReplies();
+    ponderId = id;
+    pondering = true;
+    setSearchVariant(isMiniMax);
+
+    // rank the opponent's moves, best for the opponent first
+    position = start;
+    transpositionTable->newSearch();
+    moveOrderer.newSearch();
+    timeLimited = false;
+    searchAborted = false;
+    nodeCount = 0;
+    quiescenceNodes = 0;
+    leafEvaluations = 0;
+    tablebaseHits = 0;
+    completedDepth = 0;
+
+    Move moves[MAX_MOVES];
+    int scores[MAX_MOVES];
+    int moveCount = position.generateMoves(opponent, moves);
+
+    for (int i = 0; i < moveCount && !searchAborted; i++) {
+        position.makeMove(moves[i]);
+        int score = alphabeta<Evaluator>(currentPlayer, PONDER_RANK_LEVEL, PONDER_RANK_LEVEL + 1, -999999, 999999,
+                                         currentPlayer == 'R', -1);
+        position.unmakeMove();
+
+        // scores favour green, red looks for the lowest
+        scores[i] = opponent == 'G' ? score : -score;
+    }
 
-    QTreeWidgetItem* currentItem = item;
+    for (int i = 0; i < moveCount && i < PONDER_MOVES && !searchAborted; i++) {
+        moveOrderer.pickMove(moves, scores, i, moveCount);
 
-    for (int i = 0; i < tree->topLevelItem(0)->childCount(); i++) {
-        QTreeWidgetItem* nextItem = new QTreeWidgetItem(currentItem);
-        nextItem->setText(0, tree->topLevelItem(0)->child(i)->text(0));
-        currentItem = nextItem;
+        // the reply is searched like a real move, from a position without history
+        Position after = start;
+        after.makeMove(moves[i]);
+        position = Position(after.getTokens('R'), after.getTokens('G'));
 
-        for (int j = 0; j < tree->topLevelItem(0)->child(i)->childCount(); j++) {
-            QTreeWidgetItem* nextItem2 = new QTreeWidgetItem(currentItem);
-            nextItem2->setText(0, tree->topLevelItem(0)->child(i)->child(j)->text(0));
-            currentItem = nextItem2;
+        PonderReply pondered;
+        pondered.key = getSearchKey(currentPlayer, Evaluator::INDEX);
+        pondered.level = level;
+        pondered.isMiniMax = isMiniMax;
+        pondered.heuristicIndex = Evaluator::INDEX;
+        pondered.reply = searchPosition<Evaluator>(level, currentPlayer, isMiniMax, 0);
 
-            for (int k = 0; k < tree->topLevelItem(0)->child(i)->child(j)->childCount(); k++) {
-                QTreeWidgetItem* nextItem3 = new QTreeWidgetItem(currentItem);
-                nextItem3->setText(0, tree->topLevelItem(0)->child(i)->child(j)->child(k)->text(0));
-            }
+        // a reply cut short is not worth more than the table entries it left
+        if (searchAborted)
+            break;
 
-            currentItem = nextItem;
-        }
+        pondered.completedDepth = completedDepth;
+        pondered.score = completedScore;
+        pondered.nodes = totalNodes;
+        pondered.quiescenceNodes = totalQuiescenceNodes;
+        pondered.leafEvaluations = totalLeafEvaluations;
+        pondered.tablebaseHits = totalTablebaseHits;
+        pondered.principalVariation = principalVariation;
+        pondered.trace = searchTrace;
+        searchTrace.reset();
+        ponderReplies.push_back(pondered);
+    }
+
+    pondering = false;
+}
+
+void AIPlayer::stopPondering(int id) {
+    ponderCancelled.store(id, memory_order_relaxed);
+}
+
+bool AIPlayer::wasPonderHit() {
+    return ponderHit;
+}
+
+void AIPlayer::clearPonderReplies() {
+    ponderReplies.clear();
+}
+
+int AIPlayer::getCompletedDepth() {
+    return completedDepth;
+}
+
+int AIPlayer::getScore() {
+    return completedScore;
+}
+
+const vector<Move>& AIPlayer::getPrincipalVariation() {
+    return principalVariation;
+}
+
+shared_ptr<const SearchTrace> AIPlayer::getSearchTrace() {
+    return searchTrace;
+}
 
-        currentItem = item;
+void AIPlayer::setTracing(bool enabled) {
+    tracing = enabled;
+
+    if (!tracing) {
+        searchTrace.reset();
+        iterationTrace.reset();
+        spareTrace.reset();
     }
+}
+
+void AIPlayer::stopSearch() {
+    stopRequested.store(true, memory_order_relaxed);
+}
+
+void AIPlayer::clearStopRequest() {
+    stopRequested.store(false, memory_order_relaxed);
+}
+
+void AIPlayer::setNodeLimit(uint64_t nodes) {
+    nodeLimit = nodes;
+}
+
+void AIPlayer::setIterationCallback(IterationCallback callback) {
+    iterationCallback = callback;
+}
+
+void AIPlayer::setHashSize(int sizeMB) {
+    transpositionTable->resize(sizeMB);
+}
+
+TranspositionTable* AIPlayer::getTranspositionTable() {
+    return transpositionTable.get();
+}
+
+const TTCounters& AIPlayer::getHashCounters() {
+    return hashCounters;
+}
+
+void AIPlayer::setMoveOrdering(bool enabled) {
+    moveOrdering = enabled;
+
+    for (unsigned int i = 0; i < helpers.size(); i++)
+        helpers[i]->moveOrdering = enabled;
+}
+
+MoveOrderer* AIPlayer::getMoveOrderer() {
+    return &moveOrderer;
+}
+
+uint64_t AIPlayer::getNodeCount() {
+    return totalNodes;
+}
+
+void AIPlayer::setQuiescence(bool enabled) {
+    quiescenceSearch = enabled;
+
+    for (unsigned int i = 0; i < helpers.size(); i++)
+        helpers[i]->quiescenceSearch = enabled;
+}
+
+uint64_t AIPlayer::getQuiescenceNodeCount() {
+    return totalQuiescenceNodes;
+}
+
+const SearchStats& AIPlayer::getSearchStats() {
+    return searchStats;
+}
+
+void AIPlayer::setPrincipalVariationSearch(bool enabled) {
+    principalVariationSearch = enabled;
+
+    for (unsigned int i = 0; i < helpers.size(); i++)
+        helpers[i]->principalVariationSearch = enabled;
+}
+
+uint64_t AIPlayer::getResearchCount() {
+    return researches;
+}
+
+/**
+ * @brief AIPlayer::setTablebase, endgame tables of the search and of its helpers
+ * @param tables, loaded tables, nullptr to search without
+ */
+
+void AIPlayer::setTablebase(shared_ptr<const Tablebase> tables) {
+    tablebase = tables;
+
+    for (unsigned int i = 0; i < helpers.size(); i++)
+        helpers[i]->tablebase = tables;
+}
+
+uint64_t AIPlayer::getTablebaseHits() {
+    return totalTablebaseHits;
+}
+
+void AIPlayer::setOpeningBook(shared_ptr<const OpeningBook> book) {
+    openingBook = book;
+}
+
+void AIPlayer::setBookSeed(uint64_t seed) {
+    bookRandom = seed;
+}
+
+void AIPlayer::setThreadCount(int threads) {
+    threadCount = max(1, threads);
+
+    while (static_cast<int>(helpers.size()) < threadCount - 1)
+        helpers.emplace_back(new AIPlayer(this, static_cast<int>(helpers.size()) + 1));
+
+    helpers.resize(threadCount - 1);
+
+    if (helperThreads.getSize() != threadCount - 1)
+        helperThreads.resize(threadCount - 1);
+}
 
-    uiTree->addTopLevelItem(item);
+int AIPlayer::getThreadCount() {
+    return threadCount;
 }
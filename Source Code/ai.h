@@ -2,45 +2,260 @@
 #define AI_H
 
 #include "board.h"
+#include "transposition.h"
+#include "moveorder.h"
+#include "searchtrace.h"
+#include "searchstats.h"
+#include "tablebase.h"
+#include "openingbook.h"
+#include "evaluators.h"
+#include "workerpool.h"
 #include <vector>
-#include <QTreeView>
-#include <QTreeWidgetItem>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <functional>
 
 using namespace std;
 
+// Opponent moves the AI searches a reply to while waiting for them
+const int PONDER_MOVES = 3;
+// Plies of the search that ranks the opponent's moves
+const int PONDER_RANK_LEVEL = 3;
+// Captures the quiescence search plays out past a leaf of alpha-beta
+const int QUIESCENCE_PLIES = 4;
+
+// Reply the AI found on the opponent's time, played at once
+// if the opponent makes the move it was pondered for
+struct PonderReply {
+    uint64_t key; //Search key of the position after the opponent's move
+    int level;
+    bool isMiniMax;
+    int heuristicIndex;
+    Move reply;
+    int completedDepth;
+    int score;
+    uint64_t nodes;
+    uint64_t quiescenceNodes;
+    uint64_t leafEvaluations;
+    uint64_t tablebaseHits;
+    vector<Move> principalVariation;
+    shared_ptr<SearchTrace> trace;
+};
+
+// Called by the main search after every iteration it completes
+// with the plies, score, main search nodes and best move
+typedef function<void(int depth, int score, uint64_t nodes, const Move& move)> IterationCallback;
+
 class AIPlayer{
 private:
     Board* board; //Refers to the current game
-    QTreeWidget *tree;
-    vector<int> frontierValues;
+    Position position; //Board the search plays its moves on
+    shared_ptr<SearchTrace> searchTrace; //Tree of the last completed iteration
+    shared_ptr<SearchTrace> iterationTrace; //Tree of the running iteration
+    shared_ptr<SearchTrace> spareTrace; //Taken while the others are still displayed
+    bool tracing; //Helpers keep no tree
+    shared_ptr<TranspositionTable> transpositionTable; //Kept between moves, shared with the helpers
+    TTCounters hashCounters;
+    MoveOrderer moveOrderer; //Killers and history of alpha-beta
+    bool moveOrdering;
+    shared_ptr<const Tablebase> tablebase; //Endgame tables shared with the helpers, none when null
+    uint64_t tablebaseHits; //Positions of the search the tables held
+    shared_ptr<const OpeningBook> openingBook; //Moves of the first plies, played without a search, none when null
+    uint64_t bookRandom; //Picks between the moves of the book, from OPENING_BOOK_SEED unless seeded
+    uint64_t searchVariant; //Key of the algorithm and capture search of the running search, see zobrist.h
 
-public:
-    AIPlayer(Board* current_board);
+    // iterative deepening, the clock is only read every 1024 nodes
+    chrono::steady_clock::time_point deadline;
+    bool timeLimited;
+    bool searchAborted;
+    uint64_t nodeCount;
+    uint64_t quiescenceNodes; //Nodes past the leaves, counted in nodeCount as well
+    uint64_t leafEvaluations; //Calls to the evaluator
+    bool quiescenceSearch;
+    uint64_t nodeLimit; //Nodes of the main search per move, 0 = no limit
+    IterationCallback iterationCallback;
+    Move rootBestMove; //Best root move of the running iteration
+    int completedDepth; //Plies of the last iteration that finished
+    int completedScore; //Its score, green minus red
+
+    // principal variation search, later moves of an alpha-beta node are
+    // first searched with a null window and aspiration windows narrow
+    // each iteration around the score of the one before
+    bool principalVariationSearch;
+    uint64_t researches; //Null window and aspiration searches that failed and were repeated
+    Move pvLine[MAX_PLY][MAX_PLY]; //Best line from each ply of the running iteration
+    int pvLength[MAX_PLY]; //End of the line of each ply, the ply itself when empty
+    vector<Move> principalVariation; //Best line of the last completed iteration
+
+    // Lazy SMP, helpers search the same position on their own thread
+    // and only share what they find through the transposition table
+    int threadCount;
+    int helperId; //0 for the main search
+    vector<unique_ptr<AIPlayer>> helpers;
+    WorkerPool helperThreads; //One thread per helper, started by setThreadCount
+    atomic<bool> stopHelpers;
+    const atomic<bool>* stopSignal; //Set by the main search when its move is chosen
+    atomic<bool> stopRequested; //Set from the GUI thread to play the best move found so far
+    uint64_t totalNodes;
+    uint64_t totalQuiescenceNodes;
+    uint64_t totalLeafEvaluations;
+    uint64_t totalTablebaseHits;
 
-    // return a vector of matrices representing all
-    // the possible states that the AI can choose
-    vector<vector<vector<char>>> getFrontierStates(vector<vector<char> > state, char currentPlayer);
+    // statistics of the last move, the iterations are
+    // recorded as the main search completes them
+    SearchStats searchStats;
+    chrono::steady_clock::time_point searchStart;
+    size_t tracePeakBytes;
 
-    // return heuristic associated to a given state
-    int naiveHeuristic(vector<vector<char>> state);
-    int countingHeuristic(vector<vector<char>> state);
-    int informedHeuristic(vector<vector<char>> previousState, vector<vector<char>> state, char currentPlayer);
+    // pondering, searching on the opponent's time
+    vector<PonderReply> ponderReplies;
+    bool pondering;
+    int ponderId; //Id of the running ponder
+    atomic<int> ponderCancelled; //Highest ponder id the GUI thread has stopped
+    bool ponderHit;
+
+    AIPlayer(AIPlayer* mainPlayer, int id);
+
+    // the search the helper threads join, it lives on the stack of the main search
+    struct HelperSearch {
+        AIPlayer* mainPlayer;
+        int level;
+        const Move* moves;
+        char currentPlayer;
+        bool isMiniMax;
+    };
+
+    void setSearchVariant(bool isMiniMax);
+    uint64_t getSearchKey(char currentPlayer, int heuristicIndex);
+    void storeResult(uint64_t key, int remaining, int score, int alphaOriginal, int betaOriginal, const Move* best);
+    bool isTimeUp();
+    int traceChild(int node, const Move& move);
+    void traceValue(int node, int value);
+    void updatePrincipalVariation(int ply, const Move& move);
+    void clearPonderReplies();
+    void playStoredMove(const Move& move, int score, char currentPlayer, bool isMiniMax, int heuristicIndex);
+    void collectStats(const Move& move, char currentPlayer, bool isMiniMax, int heuristicIndex);
+
+    // the search, one copy per evaluator of evaluators.h
+    // picked by the public entry points
+    template<class Evaluator>
+    Move iterativeDeepening(int level, const Move* moves, char currentPlayer, bool isMiniMax, int timeLimitMs);
+    template<class Evaluator>
+    Move searchPosition(int level, char currentPlayer, bool isMiniMax, int timeLimitMs);
+    template<class Evaluator>
+    void extendPrincipalVariation(char currentPlayer, int plies);
+    template<class Evaluator>
+    static void runHelper(void* context, int worker);
+    template<class Evaluator>
+    void ponderPosition(const Position& start, int level, char currentPlayer, bool isMiniMax, int id);
 
     // recursively calculate the heuristic value
     // of a minimax node and return the minmax
-    // value at the leaves
-    int minimax(vector<vector<char>> previousState, vector<vector<char>> state, char currentPlayer, int level, int depth, bool min_level, int heuristicIndex, QTreeWidgetItem *root);
-    int alphabeta(vector<vector<char>> previousState, vector<vector<char>> state, char currentPlayer, int level, int depth, int alpha, int beta, bool min_level, int heuristicIndex, QTreeWidgetItem *root);
-
-    // return a vector of 2 vec2 (x,y)
-    // nextMove[origPos, destPos]
-    // origPos[x0, y0] --> original position of the token that moved
-    // destPos[x1, y1] -->
-    vector<vector<int>> nextMove(vector<vector<char> > state_original, vector<vector<char> > state_new, char opponentPlayer);
-    vector<vector<int>> getNextMoveFromAI(int level, char currentPlayer, bool isMinimax, int heuristicIndex);
-
-    void setTree(QTreeWidget* tree);
+    // value at the leaves, currentPlayer is the
+    // side to move on the search position, node
+    // its index in the trace, -1 when not traced
+    template<class Evaluator>
+    int minimax(char currentPlayer, int level, int depth, bool min_level, int node);
+    template<class Evaluator>
+    int alphabeta(char currentPlayer, int level, int depth, int alpha, int beta, bool min_level, int node);
+    template<class Evaluator>
+    int quiescence(char currentPlayer, int alpha, int beta, bool min_level, int qply);
+
+public:
+    AIPlayer(Board* current_board);
+    ~AIPlayer();
+
+    // return the move chosen by the search, with
+    // its origin, destination and captured tokens;
+    // the search deepens one ply at a time up to level
+    // and stops when timeLimitMs runs out (0 = no limit),
+    // followed by the plies and score, green minus red,
+    // of the iteration the move comes from
+    Move getNextMoveFromAI(int level, char currentPlayer, bool isMinimax, int heuristicIndex, int timeLimitMs = 0);
+    int getCompletedDepth();
+    int getScore();
+
+    // moves the search expects from both sides from the current
+    // position on, starting with the chosen move, for the iteration
+    // the move comes from
+    const vector<Move>& getPrincipalVariation();
+
+    // search tree of the last move, the caller may keep it while the
+    // AI searches on; tracing is on by default, turned off the search
+    // records nothing and frees the tree
+    shared_ptr<const SearchTrace> getSearchTrace();
+    void setTracing(bool enabled);
+
+    // may be called from any thread while the search runs, it then
+    // returns the move of the last iteration that completed; the
+    // request holds until cleared so it cannot be missed by a search
+    // that has not started yet
+    void stopSearch();
+    void clearStopRequest();
+
+    // limits the nodes of the main search per move like the
+    // time limit, 0 = no limit; the callback reports the
+    // progress of the search, it runs on the search thread
+    void setNodeLimit(uint64_t nodes);
+    void setIterationCallback(IterationCallback callback);
+
+    // searches replies to the opponent's most likely moves from start
+    // while the opponent thinks, currentPlayer is the side the AI plays;
+    // the ponder runs until its replies reach the level cap or it is
+    // stopped from any thread, the next getNextMoveFromAI answers
+    // at once when the opponent played one of the pondered moves
+    void ponder(const Position& start, int level, char currentPlayer, bool isMinimax, int heuristicIndex, int id);
+    void stopPondering(int id);
+    bool wasPonderHit();
+
+    // transposition table size in megabytes, and
+    // its probe/hit/collision counters for the last move
+    void setHashSize(int sizeMB);
+    TranspositionTable* getTranspositionTable();
+    const TTCounters& getHashCounters();
+
+    // alpha-beta move ordering, on by default, and the
+    // node and first move cutoff counts of the last move
+    void setMoveOrdering(bool enabled);
+    MoveOrderer* getMoveOrderer();
+    uint64_t getNodeCount();
+
+    // captures played out past the leaves of alpha-beta, on by
+    // default, and the nodes it searched for the last move, part
+    // of the node count as well
+    void setQuiescence(bool enabled);
+    uint64_t getQuiescenceNodeCount();
+
+    // principal variation search and aspiration windows, on by
+    // default, off alpha-beta searches every move with the full
+    // window; and the searches it had to repeat for the last move
+    void setPrincipalVariationSearch(bool enabled);
+    uint64_t getResearchCount();
+
+    // endgame tables, probed inside alpha-beta and for the move
+    // itself, which is then played without a search; null turns
+    // them off; and the positions they held for the last move
+    void setTablebase(shared_ptr<const Tablebase> tables);
+    uint64_t getTablebaseHits();
+
+    // opening book, a position it holds is played from it without
+    // a search, the moves weighed by the book; null turns it off
+    void setOpeningBook(shared_ptr<const OpeningBook> book);
+
+    // seed of the picks between the moves of the book; a player starts
+    // from OPENING_BOOK_SEED so the CLI repeats its choices from run to
+    // run, the game seeds each new player so its games vary
+    void setBookSeed(uint64_t seed);
+
+    // counters, iterations and trace memory of the search
+    // behind the last move, see searchstats.h
+    const SearchStats& getSearchStats();
+
+    // number of threads of an alpha-beta search, 1 keeps
+    // the search single threaded and deterministic
+    void setThreadCount(int threads);
+    int getThreadCount();
 };
 
 #endif // AI_H
-
@@ -0,0 +1,91 @@
+#include "aiworker.h"
+
+#include <QElapsedTimer>
+
+AIWorker::AIWorker(QObject *parent) : QObject(parent)
+{
+    qRegisterMetaType<Move>("Move");
+    qRegisterMetaType<Position>("Position");
+    qRegisterMetaType<AIPlayer*>("AIPlayer*");
+    qRegisterMetaType<MCTSPlayer*>("MCTSPlayer*");
+    qRegisterMetaType<Game*>("Game*");
+}
+
+/**
+ * @brief AIWorker::configure, applies the search options on the worker thread, after
+ *        a ponder still running has stopped and before the next search starts
+ * @param ai, the AI of the game
+ * @param threadCount, threads of an alpha-beta search
+ * @param tracing, whether the search records its tree
+ */
+
+void AIWorker::configure(AIPlayer* ai, int threadCount, bool tracing) {
+    ai->setThreadCount(threadCount);
+    ai->setTracing(tracing);
+}
+
+/**
+ * @brief AIWorker::search, runs the search on the worker thread and reports its move
+ * @param ai, the AI of the game, nothing else touches it until moveFound arrives
+ * @param searchId, handed back with the move so the window can drop stale results
+ * @param level, deepest search allowed, 1 + the number of plies
+ * @param currentPlayer, the side the AI plays
+ * @param isMinimax, minimax or alpha-beta
+ * @param heuristicIndex, 0 = naive, 1 = counting, 2 = informed
+ * @param timeLimitMs, wall clock budget in milliseconds, 0 = no limit
+ */
+
+void AIWorker::search(AIPlayer* ai, int searchId, int level, char currentPlayer, bool isMinimax, int heuristicIndex, int timeLimitMs) {
+    QElapsedTimer timer;
+    timer.start();
+
+    Move move = ai->getNextMoveFromAI(level, currentPlayer, isMinimax, heuristicIndex, timeLimitMs);
+
+    emit moveFound(searchId, move, timer.elapsed());
+}
+
+/**
+ * @brief AIWorker::searchMonteCarlo, runs a Monte Carlo tree search on the worker thread
+ *        and reports its move like search
+ * @param mcts, the Monte Carlo player of the game
+ * @param searchId, handed back with the move so the window can drop stale results
+ * @param currentPlayer, the side the AI plays
+ * @param threadCount, threads growing the tree
+ * @param timeLimitMs, wall clock budget in milliseconds, 0 = the default playout count
+ */
+
+void AIWorker::searchMonteCarlo(MCTSPlayer* mcts, int searchId, char currentPlayer, int threadCount, int timeLimitMs) {
+    QElapsedTimer timer;
+    timer.start();
+
+    mcts->setThreadCount(threadCount);
+    Move move = mcts->getNextMoveFromMCTS(currentPlayer, timeLimitMs);
+
+    emit moveFound(searchId, move, timer.elapsed());
+}
+
+/**
+ * @brief AIWorker::ponder, searches replies to the human's likely moves until stopped,
+ *        a search asked for meanwhile waits in the queue until the ponder has stopped
+ * @param ai, the AI of the game
+ * @param start, the game board after the AI's move
+ * @param ponderId, passed to AIPlayer::stopPondering to end this ponder
+ * @param level, deepest search allowed, 1 + the number of plies
+ * @param currentPlayer, the side the AI plays
+ * @param isMinimax, minimax or alpha-beta
+ * @param heuristicIndex, 0 = naive, 1 = counting, 2 = informed
+ */
+
+void AIWorker::ponder(AIPlayer* ai, Position start, int ponderId, int level, char currentPlayer, bool isMinimax, int heuristicIndex) {
+    ai->ponder(start, level, currentPlayer, isMinimax, heuristicIndex, ponderId);
+}
+
+/**
+ * @brief AIWorker::release, deletes a game that was replaced by a new one with its AI,
+ *        the searches and ponders queued for it before have all returned by then
+ * @param game, the game the window no longer uses
+ */
+
+void AIWorker::release(Game* game) {
+    delete game;
+}
@@ -0,0 +1,41 @@
+#ifndef AIWORKER_H
+#define AIWORKER_H
+
+#include <QObject>
+#include <QMetaType>
+
+#include "ai.h"
+#include "mcts.h"
+#include "game.h"
+
+Q_DECLARE_METATYPE(Move)
+Q_DECLARE_METATYPE(Position)
+Q_DECLARE_METATYPE(AIPlayer*)
+Q_DECLARE_METATYPE(MCTSPlayer*)
+Q_DECLARE_METATYPE(Game*)
+
+/**
+ * Runs the AI search on its own thread so the window keeps repainting while
+ * the AI thinks. MainWindow moves it to a QThread and asks for moves through
+ * a queued signal, the chosen move comes back the same way. Between moves it
+ * ponders on the human's time until the window stops it.
+ */
+class AIWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AIWorker(QObject *parent = 0);
+
+public slots:
+    void configure(AIPlayer* ai, int threadCount, bool tracing);
+    void search(AIPlayer* ai, int searchId, int level, char currentPlayer, bool isMinimax, int heuristicIndex, int timeLimitMs);
+    void ponder(AIPlayer* ai, Position start, int ponderId, int level, char currentPlayer, bool isMinimax, int heuristicIndex);
+    void searchMonteCarlo(MCTSPlayer* mcts, int searchId, char currentPlayer, int threadCount, int timeLimitMs);
+    void release(Game* game);
+
+signals:
+    void moveFound(int searchId, Move move, qint64 elapsedMs);
+};
+
+#endif // AIWORKER_H
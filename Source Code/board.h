@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "integer.h"
+#include "position.h"
 
 using namespace std;
 
@@ -12,27 +13,29 @@ class Board
 private:
     const int WIDTH = 9;
     const int HEIGHT = 5;
-    vector<vector<char>> boardMatrix;
+    Position position;
 
 public:
     Board();
     Board(vector<vector<char> >);
+    Board(Position state);
     int getWidth();
     int getHeight();
     vector<vector<char>> getMatrix();
+    Position getPosition();
     char getValueAt(int x, int y);
     bool getTileColor(int x, int y);
     bool checkMove(int x1, int y1, int x2, int y2);
-    void performAttack(int x1, int y1, int x2, int y2, Integer* moveCtr, Integer* defensiveMoveCtr, Integer* offensiveMoveCtr, Integer* p1Tokens, Integer* p2Tokens);
+    Move performAttack(int x1, int y1, int x2, int y2, Integer* moveCtr, Integer* defensiveMoveCtr, Integer* offensiveMoveCtr, Integer* p1Tokens, Integer* p2Tokens);
+    void performMove(const Move& move, Integer* moveCtr, Integer* defensiveMoveCtr, Integer* offensiveMoveCtr, Integer* p1Tokens, Integer* p2Tokens);
     vector<vector<int>> getEmptyAdjacentValidTiles(int x, int y);
     vector<vector<int>> getEmptyAdjacentInvalidTiles(int x, int y);
-    int getTokenStreak(int x, int y, char player, vector<vector<char>> currentState);
+    int getTokenStreak(int x, int y, char player, const Position& currentState);
     int getTokenAmount(char player);
     void updateBoard(int x1, int y1, int x2, int y2);
     void printBoard();
-    void attack(int x, int y, vector<int> direction, char currentPlayer, Integer* moveCtr, Integer* defensiveMoveCtr, Integer* offensiveMoveCtr, Integer* p1Tokens, Integer* p2Tokens);
     void setMatrix(vector<vector<char>> new_matrix);
-    vector<vector<int>> getRemovedTokens(vector<vector<char>> state_original, vector<vector<char>> state_new, char currentPlayer);
+    void setPosition(Position new_position);
 };
 
 #endif // BOARD_H
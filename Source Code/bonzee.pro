@@ -0,0 +1,39 @@
+#-------------------------------------------------
+#
+# Builds the engine core, then the game and the
+# command-line tools that link it
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    engine \
+    app \
+    cli \
+    smpbench \
+    tournament \
+    bench \
+    tbgen \
+    bookgen
+
+app.file = 472_ai_project.pro
+app.depends = engine
+
+cli.subdir = tools/cli
+cli.depends = engine
+
+smpbench.subdir = tools/smpbench
+smpbench.depends = engine
+
+tournament.subdir = tools/tournament
+tournament.depends = engine
+
+bench.subdir = tools/bench
+bench.depends = engine
+
+tbgen.subdir = tools/tbgen
+tbgen.depends = engine
+
+bookgen.subdir = tools/bookgen
+bookgen.depends = engine
@@ -0,0 +1,15 @@
+# Links the engine core, include it from every project that uses the engine
+# (they are built after it by the top-level bonzee.pro)
+
+INCLUDEPATH += $$PWD/..
+DEPENDPATH += $$PWD/..
+CONFIG += thread
+
+ENGINE_LIB_DIR = $$shadowed($$PWD)
+win32:CONFIG(release, debug|release): ENGINE_LIB_DIR = $$ENGINE_LIB_DIR/release
+else:win32:CONFIG(debug, debug|release): ENGINE_LIB_DIR = $$ENGINE_LIB_DIR/debug
+
+LIBS += -L$$ENGINE_LIB_DIR -lbonzeecore
+
+win32:!win32-g++: PRE_TARGETDEPS += $$ENGINE_LIB_DIR/bonzeecore.lib
+else: PRE_TARGETDEPS += $$ENGINE_LIB_DIR/libbonzeecore.a
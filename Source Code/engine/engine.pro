@@ -0,0 +1,60 @@
+#-------------------------------------------------
+#
+# Engine core: board, rules and search, without
+# Qt so it also builds on headless hosts
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = bonzeecore
+TEMPLATE = lib
+CONFIG += staticlib
+QMAKE_CXXFLAGS += -std=c++14
+
+CORE = ..
+INCLUDEPATH += $$CORE
+
+SOURCES += \
+        $$CORE/ai.cpp \
+        $$CORE/mcts.cpp \
+        $$CORE/board.cpp \
+        $$CORE/game.cpp \
+        $$CORE/player.cpp \
+        $$CORE/integer.cpp \
+        $$CORE/position.cpp \
+        $$CORE/transposition.cpp \
+        $$CORE/moveorder.cpp \
+        $$CORE/searchtrace.cpp \
+        $$CORE/searchstats.cpp \
+        $$CORE/workerpool.cpp \
+        $$CORE/notation.cpp \
+        $$CORE/protocol.cpp \
+        $$CORE/perft.cpp \
+        $$CORE/mappedfile.cpp \
+        $$CORE/tablebase.cpp \
+        $$CORE/openingbook.cpp
+
+HEADERS += \
+        $$CORE/ai.h \
+        $$CORE/mcts.h \
+        $$CORE/board.h \
+        $$CORE/game.h \
+        $$CORE/player.h \
+        $$CORE/integer.h \
+        $$CORE/position.h \
+        $$CORE/movetables.h \
+        $$CORE/move.h \
+        $$CORE/zobrist.h \
+        $$CORE/transposition.h \
+        $$CORE/moveorder.h \
+        $$CORE/searchtrace.h \
+        $$CORE/searchstats.h \
+        $$CORE/workerpool.h \
+        $$CORE/notation.h \
+        $$CORE/protocol.h \
+        $$CORE/perft.h \
+        $$CORE/mappedfile.h \
+        $$CORE/tablebase.h \
+        $$CORE/openingbook.h \
+        $$CORE/evaluators.h
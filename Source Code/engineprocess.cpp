@@ -0,0 +1,158 @@
+#include "engineprocess.h"
+#include "notation.h"
+
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QStringList>
+
+EngineProcess::EngineProcess(QObject *parent) : QObject(parent), process(new QProcess(this)), pendingSearches(0)
+{
+    connect(process, SIGNAL(readyReadStandardOutput()), this, SLOT(readOutput()));
+    connect(process, SIGNAL(errorOccurred(QProcess::ProcessError)), this, SLOT(processError(QProcess::ProcessError)));
+    connect(process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(processFinished(int,QProcess::ExitStatus)));
+}
+
+EngineProcess::~EngineProcess()
+{
+    if (process->state() == QProcess::NotRunning)
+        return;
+
+    send(QString::fromStdString("quit"));
+
+    if (!process->waitForFinished(1000))
+        process->kill();
+}
+
+QString EngineProcess::findEngine() {
+    QString path = QString::fromLocal8Bit(qgetenv("BONZEE_ENGINE"));
+
+    if (!path.isEmpty())
+        return path;
+
+    QString appDir = QCoreApplication::applicationDirPath();
+
+    return QStandardPaths::findExecutable(QString::fromStdString("bonzee"),
+                                          QStringList() << appDir << appDir + QString::fromStdString("/tools/cli"));
+}
+
+/**
+ * @brief EngineProcess::start, launches the engine unless it already runs
+ * @return whether the engine is running
+ */
+
+bool EngineProcess::start() {
+    if (process->state() == QProcess::Running)
+        return true;
+
+    QString program = findEngine();
+
+    if (program.isEmpty())
+        return false;
+
+    pendingSearches = 0;
+    process->start(program, QStringList() << QString::fromStdString("--protocol"));
+
+    return process->waitForStarted(3000);
+}
+
+/**
+ * @brief EngineProcess::search, asks the engine for a move, the engine answers with
+ *        info lines while it searches and moveFound once it is done
+ * @param position, the game board
+ * @param currentPlayer, the side the AI plays
+ * @param plies, deepest search allowed
+ * @param algorithm, minimax, alphabeta or mcts
+ * @param heuristicIndex, 0 = naive, 1 = counting, 2 = informed
+ * @param timeLimitMs, wall clock budget in milliseconds, 0 = no limit
+ * @param threadCount, threads of an alpha-beta search
+ */
+
+void EngineProcess::search(const Position& position, char currentPlayer, int plies, const QString& algorithm, int heuristicIndex,
+                           int timeLimitMs, int threadCount) {
+    pendingSearches++;
+
+    send(QString::fromStdString("setoption threads ") + QString::number(threadCount));
+    send(QString::fromStdString("position ") + QString::fromStdString(positionName(position))
+         + QString::fromStdString(currentPlayer == 'R' ? " R" : " G"));
+    send(QString::fromStdString("go depth ") + QString::number(plies)
+         + QString::fromStdString(" time ") + QString::number(timeLimitMs)
+         + QString::fromStdString(" algorithm ") + algorithm
+         + QString::fromStdString(" heuristic ") + QString::number(heuristicIndex));
+}
+
+void EngineProcess::stop() {
+    if (process->state() == QProcess::Running)
+        send(QString::fromStdString("stop"));
+}
+
+void EngineProcess::send(const QString& line) {
+    process->write((line + QString::fromStdString("\n")).toUtf8());
+}
+
+/**
+ * @brief EngineProcess::readOutput, passes on the lines of the engine, those of a search
+ *        that was replaced by a newer one are dropped
+ */
+
+void EngineProcess::readOutput() {
+    while (process->canReadLine()) {
+        QString line = QString::fromUtf8(process->readLine()).simplified();
+
+        if (line.isEmpty())
+            continue;
+
+        QStringList words = line.split(QChar(' '));
+
+        if (words[0] == QString::fromStdString("bestmove")) {
+            if (pendingSearches == 0 || --pendingSearches > 0)
+                continue;
+
+            int score = 0, depth = 0;
+            qulonglong nodes = 0;
+            qint64 elapsedMs = 0;
+
+            for (int i = 2; i + 1 < words.size(); i += 2) {
+                if (words[i] == QString::fromStdString("score"))
+                    score = words[i + 1].toInt();
+                else if (words[i] == QString::fromStdString("depth"))
+                    depth = words[i + 1].toInt();
+                else if (words[i] == QString::fromStdString("nodes"))
+                    nodes = words[i + 1].toULongLong();
+                else if (words[i] == QString::fromStdString("time"))
+                    elapsedMs = words[i + 1].toLongLong();
+            }
+
+            // the playouts of an mcts search only show in the log
+            if (words.contains(QString::fromStdString("playouts")))
+                emit info(line);
+
+            emit moveFound(words.size() > 1 ? words[1] : QString(), score, depth, nodes, elapsedMs);
+        }
+        else if (pendingSearches == 1) {
+            emit info(line);
+        }
+    }
+}
+
+void EngineProcess::processError(QProcess::ProcessError error) {
+    if (pendingSearches == 0)
+        return;
+
+    pendingSearches = 0;
+
+    if (error == QProcess::FailedToStart)
+        emit failed(QString::fromStdString("the engine did not start"));
+    else if (error == QProcess::Crashed)
+        emit failed(QString::fromStdString("the engine crashed"));
+    else
+        emit failed(process->errorString());
+}
+
+void EngineProcess::processFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    // a crash is already reported by processError
+    if (pendingSearches == 0 || exitStatus == QProcess::CrashExit)
+        return;
+
+    pendingSearches = 0;
+    emit failed(QString::fromStdString("the engine quit with code ") + QString::number(exitCode));
+}
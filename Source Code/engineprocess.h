@@ -0,0 +1,46 @@
+#ifndef ENGINEPROCESS_H
+#define ENGINEPROCESS_H
+
+#include <QObject>
+#include <QProcess>
+
+#include "position.h"
+
+/**
+ * Runs the AI in a bonzee engine process and talks to it with the line
+ * protocol of protocol.h, so a crash or a runaway search of the engine
+ * cannot take the window down. The engine is found through the
+ * BONZEE_ENGINE environment variable, or next to the game executable.
+ */
+class EngineProcess : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EngineProcess(QObject *parent = 0);
+    ~EngineProcess();
+
+    bool start();
+    void search(const Position& position, char currentPlayer, int plies, const QString& algorithm, int heuristicIndex,
+                int timeLimitMs, int threadCount);
+    void stop();
+
+signals:
+    void info(QString line);
+    void moveFound(QString move, int score, int depth, qulonglong nodes, qint64 elapsedMs);
+    void failed(QString reason);
+
+private slots:
+    void readOutput();
+    void processError(QProcess::ProcessError error);
+    void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    QProcess* process;
+    int pendingSearches; //Only the reply to the last search is reported
+
+    static QString findEngine();
+    void send(const QString& line);
+};
+
+#endif // ENGINEPROCESS_H
@@ -0,0 +1,108 @@
+#ifndef EVALUATORS_H
+#define EVALUATORS_H
+
+#include "movetables.h"
+
+/* Heuristics of the search, one evaluator type each. minimax and alphabeta
+ * are templates over the evaluator, so every heuristic gets its own copy of
+ * the search with its evaluate inlined into the leaves, and withEvaluator
+ * picks the copy once per search from the heuristic index.
+ *
+ * An evaluator has an INDEX, which also keeps its scores apart in the
+ * transposition table, and a static evaluate returning the score of the
+ * position, green minus red; previousPlayer is the side that moved into it.
+ * captureGain bounds how far a capture can move that score, for the
+ * delta pruning of the quiescence search, and ASPIRATION_WINDOW is how far
+ * one iteration of alpha-beta is expected to move it from the last.
+ * A new heuristic is a new evaluator and a case in withEvaluator, the search
+ * itself does not change. */
+
+const int EVALUATOR_COUNT = 3;
+
+// naive heuristic function described in the project section of the moodle
+// page, each column and row weighted by its 1-based index
+struct NaiveEvaluator {
+    static const int INDEX = 0;
+    static const int ASPIRATION_WINDOW = 150;
+
+    static int evaluate(const Position& state, char) {
+        return state.getPlacementScore();
+    }
+
+    // the captured tokens and a step of one row and one column
+    static int captureGain(const Move& move) {
+        int gain = placementWeight(0) + 50;
+        uint64_t captured = move.captured;
+
+        while (captured) {
+            gain += placementWeight(firstSquare(captured));
+            captured &= captured - 1;
+        }
+
+        return gain;
+    }
+};
+
+// difference in token count
+struct CountingEvaluator {
+    static const int INDEX = 1;
+    static const int ASPIRATION_WINDOW = 1;
+
+    static int evaluate(const Position& state, char) {
+        return state.getTokenAmount('G') - state.getTokenAmount('R');
+    }
+
+    static int captureGain(const Move& move) {
+        return move.captureCount;
+    }
+};
+
+// tokens on white tiles are worth 100, on black tiles 50, corrected by the
+// streaks of either side around the landing tile of the last move
+struct InformedEvaluator {
+    static const int INDEX = 2;
+    static const int ASPIRATION_WINDOW = 50;
+
+    static int evaluate(const Position& state, char previousPlayer) {
+        int heuristicValue = state.getTileScore();
+
+        if (state.getUndoCount() == 0)
+            return heuristicValue;
+
+        char opponentPlayer = previousPlayer == 'G' ? 'R' : 'G';
+        int square = state.getLastMove().to;
+        int defensiveValue = tokenStreak(square, state.getTokens(previousPlayer));
+        int offensiveValue = tokenStreak(square, state.getTokens(opponentPlayer));
+
+        if (previousPlayer == 'G')
+            return heuristicValue - 5 * defensiveValue + 10 * offensiveValue;
+
+        return heuristicValue + 5 * defensiveValue - 10 * offensiveValue;
+    }
+
+    // the captured tokens, a step from a black to a white tile, and the
+    // streak terms of the old and the new landing tile, 8 tokens at most
+    static int captureGain(const Move& move) {
+        return 100 * move.captureCount + 50 + 2 * (5 + 10) * 8;
+    }
+};
+
+/**
+ * @brief withEvaluator, calls search with a default constructed evaluator of the
+ *        heuristic, search takes it as an auto parameter and reads its type
+ * @param heuristicIndex, 0 = naive, 1 = counting, 2 = informed
+ * @return what search returns
+ */
+template<class Search>
+auto withEvaluator(int heuristicIndex, Search&& search) -> decltype(search(NaiveEvaluator())) {
+    switch (heuristicIndex) {
+    case CountingEvaluator::INDEX:
+        return search(CountingEvaluator());
+    case InformedEvaluator::INDEX:
+        return search(InformedEvaluator());
+    default:
+        return search(NaiveEvaluator());
+    }
+}
+
+#endif // EVALUATORS_H
@@ -8,21 +8,33 @@ Game::Game()
     defensiveMoveCtr = new Integer(0);
     offensiveMoveCtr = new Integer(0);
     moveCtr = new Integer(0);
+    ai = nullptr;
+    mcts = nullptr;
     turn = true;
     isGameOver = false;
 }
 
 Game::~Game() {
+    delete ai;
+    delete mcts;
     delete board;
-    delete AI_board;
+    delete p1Tokens;
+    delete p2Tokens;
+    delete defensiveMoveCtr;
+    delete offensiveMoveCtr;
+    delete moveCtr;
 }
 
 Board* Game::getBoard() {
     return board;
 }
 
-void Game::attack(int x1, int y1, int x2, int y2) {
-    board->performAttack(x1, y1, x2, y2, moveCtr, defensiveMoveCtr, offensiveMoveCtr, p1Tokens, p2Tokens);
+Move Game::attack(int x1, int y1, int x2, int y2) {
+    return board->performAttack(x1, y1, x2, y2, moveCtr, defensiveMoveCtr, offensiveMoveCtr, p1Tokens, p2Tokens);
+}
+
+void Game::performMove(const Move& move) {
+    board->performMove(move, moveCtr, defensiveMoveCtr, offensiveMoveCtr, p1Tokens, p2Tokens);
 }
 
 int Game::getPlayerTokens(int player) {
@@ -53,6 +65,10 @@ AIPlayer* Game::getAI() {
     return ai;
 }
 
+MCTSPlayer* Game::getMCTS() {
+    return mcts;
+}
+
 bool Game::checkGameOver() {
     if (p1Tokens->getValue() <= 0 || p2Tokens->getValue() <= 0)
         isGameOver = true;
@@ -66,6 +82,7 @@ void Game::switchTurn() {
 
 void Game::createAI() {
     ai = new AIPlayer(board);
+    mcts = new MCTSPlayer(board);
 }
 
 void Game::updateDefensiveMoveCtr(int amt) {
@@ -94,7 +111,7 @@ void Game::setPlayerTokens(int player, int tokens) {
 }
 
 bool Game::checkStalemate() {
-    if (defensiveMoveCtr->getValue() >= 10)
+    if (defensiveMoveCtr->getValue() >= STALEMATE_MOVES)
         return isGameOver = true;
 
     return false;
@@ -4,14 +4,18 @@
 #include "board.h"
 #include "player.h"
 #include "ai.h"
+#include "mcts.h"
 #include "integer.h"
 
+// Consecutive moves without a capture that end the game in a draw
+const int STALEMATE_MOVES = 10;
+
 class Game
 {
 private:
     Board* board;
-    Board* AI_board;
     AIPlayer* ai;
+    MCTSPlayer* mcts;
     Integer* p1Tokens;
     Integer* p2Tokens;
     bool turn;
@@ -24,13 +28,15 @@ public:
     Game();
     ~Game();
     Board *getBoard();
-    void attack(int x1, int y1, int x2, int y2);
+    Move attack(int x1, int y1, int x2, int y2);
+    void performMove(const Move& move);
     int getPlayerTokens(int player);
     int getDefensiveMoveCtr();
     int getOffensiveMoveCtr();
     int getMoveCtr();
     bool getTurn();
     AIPlayer* getAI();
+    MCTSPlayer* getMCTS();
     bool checkGameOver();
     void switchTurn();
     void createAI();
@@ -1,6 +1,11 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <random>
+
 /**
  * @brief MainWindow::MainWindow, QWidget constructor
  * @param parent, window application
@@ -12,10 +17,63 @@ MainWindow::MainWindow(QWidget *parent) :
 {
     ui->setupUi(this);
 
+    game = nullptr;
     inProgress = false;
     part_1 = true;
     firstStart = true;
     savedCoordinates.resize(2);
+    aiThinking = false;
+    searchId = 0;
+    aiPondering = false;
+    ponderId = 0;
+    engineSearching = false;
+    monteCarloSearching = false;
+
+    // The AI searches on its own thread, moves are asked for and
+    // handed back through queued signals
+    aiThread = new QThread(this);
+    aiWorker = new AIWorker();
+    aiWorker->moveToThread(aiThread);
+    connect(aiThread, SIGNAL(finished()), aiWorker, SLOT(deleteLater()));
+    connect(this, SIGNAL(configureRequested(AIPlayer*,int,bool)),
+            aiWorker, SLOT(configure(AIPlayer*,int,bool)));
+    connect(this, SIGNAL(searchRequested(AIPlayer*,int,int,char,bool,int,int)),
+            aiWorker, SLOT(search(AIPlayer*,int,int,char,bool,int,int)));
+    connect(this, SIGNAL(ponderRequested(AIPlayer*,Position,int,int,char,bool,int)),
+            aiWorker, SLOT(ponder(AIPlayer*,Position,int,int,char,bool,int)));
+    connect(this, SIGNAL(monteCarloRequested(MCTSPlayer*,int,char,int,int)),
+            aiWorker, SLOT(searchMonteCarlo(MCTSPlayer*,int,char,int,int)));
+    connect(this, SIGNAL(releaseRequested(Game*)),
+            aiWorker, SLOT(release(Game*)));
+    connect(aiWorker, SIGNAL(moveFound(int,Move,qint64)),
+            this, SLOT(aiMoveFound(int,Move,qint64)));
+    aiThread->start();
+
+    // Or in an engine process, through its line protocol
+    engine = new EngineProcess(this);
+    connect(engine, SIGNAL(moveFound(QString,int,int,qulonglong,qint64)),
+            this, SLOT(engineMoveFound(QString,int,int,qulonglong,qint64)));
+    connect(engine, SIGNAL(info(QString)), this, SLOT(engineInfo(QString)));
+    connect(engine, SIGNAL(failed(QString)), this, SLOT(engineFailed(QString)));
+
+    treeModel = new SearchTreeModel(this);
+    ui->tree->setModel(treeModel);
+
+    // Statistics of every AI move, in a floating panel the stats box shows
+    statsLabel = new QLabel();
+    statsLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
+    statsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    statsLabel->setMinimumSize(260, 320);
+    statsLabel->setFont(QFont(QString::fromStdString("Courier"), 9));
+    statsLabel->setStyleSheet("background: black; color: green; padding: 6px;");
+    statsLabel->setText(QString::fromStdString("No AI move yet"));
+    statsDock = new QDockWidget(QString::fromStdString("AI statistics"), this);
+    statsDock->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable);
+    statsDock->setWidget(statsLabel);
+    addDockWidget(Qt::RightDockWidgetArea, statsDock);
+    statsDock->setFloating(true);
+    statsDock->hide();
+    connect(ui->statsBox, SIGNAL(toggled(bool)), statsDock, SLOT(setVisible(bool)));
 
     // Connect depth slider and spin
     connect(ui->depthSlider, SIGNAL(valueChanged(int)),
@@ -23,6 +81,9 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(ui->depthEdit, SIGNAL(valueChanged(int)),
             ui->depthSlider, SLOT(setValue(int)));
 
+    // One search thread per core at most
+    ui->threadEdit->setMaximum(qMax(1, QThread::idealThreadCount()));
+
     Q_INIT_RESOURCE(resources);
 
     // Store red and green icons
@@ -40,6 +101,7 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(ui->expandButton, SIGNAL(clicked()), SLOT(expand()));
     connect(ui->reduceButton, SIGNAL(clicked()), SLOT(collapse()));
     connect(ui->endButton, SIGNAL(clicked()), SLOT(close()));
+    connect(ui->stopButton, SIGNAL(clicked()), SLOT(moveNow()));
 }
 
 /**
@@ -48,6 +110,17 @@ MainWindow::MainWindow(QWidget *parent) :
 
 MainWindow::~MainWindow()
 {
+    // A running search ends after its current iteration, the
+    // engine process is told to quit when it is deleted
+    if (aiThinking && !engineSearching)
+        stopSearch();
+
+    stopPondering();
+
+    aiThread->quit();
+    aiThread->wait();
+
+    delete game;
     delete ui;
 }
 
@@ -57,8 +130,8 @@ MainWindow::~MainWindow()
  */
 
 void MainWindow::gameButtonClicked() {
-    // Only allow for button clicks if game is in progress
-    if (inProgress) {
+    // Only allow for button clicks if game is in progress and the AI is not thinking
+    if (inProgress && !aiThinking) {
         setButtonsColor();
 
         // Fetch button position
@@ -85,23 +158,13 @@ void MainWindow::gameButtonClicked() {
             }
             // If second click is empty tile
             else {
-                vector<vector<char>> originalState;
-                vector<vector<char>> newState;
-                vector<vector<int>> removedTokens;
-
-                originalState = game->getBoard()->getMatrix();
-                game->attack(savedCoordinates[0], savedCoordinates[1], x, y);
-                newState = game->getBoard()->getMatrix();
-
-                if (game->getTurn())
-                    removedTokens = game->getBoard()->getRemovedTokens(originalState, newState, 'G');
-                else
-                    removedTokens = game->getBoard()->getRemovedTokens(originalState, newState, 'R');
+                // The move comes back with its captures already resolved
+                Move move = game->attack(savedCoordinates[0], savedCoordinates[1], x, y);
 
                 if (!ui->aiBox->isChecked())
-                    setRemovedTokensColors(removedTokens);
+                    setRemovedTokensColors(move);
 
-                displayMove(savedCoordinates[0], savedCoordinates[1], x, y);
+                displayMove(move);
             }
 
             // AI turn right after player's if enabled
@@ -133,12 +196,50 @@ void MainWindow::gameButtonClicked() {
  */
 
 void MainWindow::startGame() {
-    // Create a new game
+    // Create a new game, the last one is deleted on the worker thread
+    // once the search or ponder it may still run has returned
+    if (game)
+        emit releaseRequested(game);
+
     game = new Game();
 
-    if (ui->aiBox->isChecked())
+    if (ui->aiBox->isChecked()) {
         game->createAI();
 
+        // The tables are mapped once, without them the AI searches endgames like the rest
+        if (!tablebase) {
+            shared_ptr<Tablebase> tables = make_shared<Tablebase>();
+
+            if (tables->load(getTablebasePath().toLocal8Bit().toStdString()) > 0)
+                ui->messageText->append(QString::fromStdString(" >>> Endgame tables loaded: ")
+                                        + QString::number(tables->getTableCount()));
+
+            tablebase = tables;
+        }
+
+        if (tablebase->getTableCount() > 0)
+            game->getAI()->setTablebase(tablebase);
+
+        // So is the opening book, without it the AI searches the first moves as well
+        if (!openingBook) {
+            shared_ptr<OpeningBook> book = make_shared<OpeningBook>();
+
+            if (book->load(getOpeningBookPath().toLocal8Bit().toStdString()))
+                ui->messageText->append(QString::fromStdString(" >>> Opening book loaded: ")
+                                        + QString::number(book->getHeader()->entryCount)
+                                        + QString::fromStdString(" moves"));
+
+            openingBook = book;
+        }
+
+        // A new seed every game, or the AI answers the same moves with the same book moves
+        if (openingBook->isLoaded()) {
+            random_device seed;
+            game->getAI()->setOpeningBook(openingBook);
+            game->getAI()->setBookSeed(static_cast<uint64_t>(seed()) << 32 | seed());
+        }
+    }
+
     // Initialize the board's UI
     if (firstStart) {
         firstStart = !firstStart;
@@ -182,6 +283,21 @@ void MainWindow::restartGame() {
     disableAllButtons();
     inProgress = false;
 
+    // Drop the move of a search still running
+    if (aiThinking) {
+        if (engineSearching)
+            engine->stop();
+        else
+            stopSearch();
+
+        aiThinking = false;
+        engineSearching = false;
+        monteCarloSearching = false;
+        setStopButtonEnabled(false);
+    }
+
+    stopPondering();
+
     // Reset the style of all buttons beck to idle state
     for (unsigned int i = 0; i < gameButtons.size(); i++) {
         for (unsigned int j = 0; j < gameButtons[i].size(); j++) {
@@ -218,11 +334,12 @@ void MainWindow::clearMessages() {
 }
 
 /**
- * @brief MainWindow::expand, expands all nodes of the AI tree at once
+ * @brief MainWindow::expand, expands the first three levels of the AI tree at once,
+ *        deeper nodes are expanded one by one
  */
 
 void MainWindow::expand() {
-    ui->tree->expandAll();
+    ui->tree->expandToDepth(1);
 }
 
 /**
@@ -312,6 +429,10 @@ void MainWindow::updateBoard() {
             }
         }
     }
+
+    // Board input stays locked until the AI's move arrives
+    if (aiThinking)
+        disableAllButtons();
 }
 
 /**
@@ -539,73 +660,375 @@ void MainWindow::setClickedButtonColor(int x, int y) {
 }
 
 /**
- * @brief MainWindow::performAITurn, performs the AI turn and displays the action it took
+ * @brief MainWindow::performAITurn, starts the AI search on the worker thread,
+ *        aiMoveFound plays and displays the move once it is found
  */
 
 void MainWindow::performAITurn() {
     ui->messageText->append(QString::fromStdString(" >>>\n >>> Player AI turn"));
+
+    // The human has moved, what the ponder found is kept by the AI
+    stopPondering();
+
+    // Lock the board until the move arrives
+    aiThinking = true;
+    disableAllButtons();
+    setStopButtonEnabled(true);
+    searchId++;
+
+    if (ui->engineBox->isChecked()) {
+        if (engine->start()) {
+            engineSearching = true;
+            engine->search(game->getBoard()->getPosition(), ui->redRadio->isChecked() ? 'R' : 'G',
+                           ui->depthSlider->value(), getAlgorithmName(), getHeuristicIndex(),
+                           ui->timeEdit->value(), ui->threadEdit->value());
+            return;
+        }
+
+        ui->messageText->append(QString::fromStdString(" >>> Engine process not found, the AI searches in the game"));
+    }
+
+    searchInProcess();
+}
+
+/**
+ * @brief MainWindow::searchInProcess, starts the AI search on the worker thread,
+ *        aiMoveFound plays the move once it is found
+ */
+
+void MainWindow::searchInProcess() {
     bool isMinimax = ui->algoRadio_1->isChecked();
-    int heuristicIndex;
+    int heuristicIndex = getHeuristicIndex();
+    char aiColor = ui->redRadio->isChecked() ? 'R' : 'G';
 
-    if (ui->heuristicRadio_1->isChecked())
-        heuristicIndex = 0;
-    else if (ui->heuristicRadio_2->isChecked())
-        heuristicIndex = 1;
-    else if (ui->heuristicRadio_3->isChecked())
-        heuristicIndex = 2;
-    else
-        heuristicIndex = 0;
+    // Monte Carlo tree search plays out games until the time per move is up
+    if (ui->algoRadio_3->isChecked()) {
+        monteCarloSearching = true;
+        game->getMCTS()->clearStopRequest();
+
+        emit monteCarloRequested(game->getMCTS(), searchId, aiColor, ui->threadEdit->value(), ui->timeEdit->value());
+        return;
+    }
 
-    // Begin timer
-    clock_t begin = clock();
+    // The search deepens until the depth cap or the time per move is reached
+    int depthCap = ui->depthSlider->value() + 1;
+    int timeLimit = ui->timeEdit->value();
+    emit configureRequested(game->getAI(), ui->threadEdit->value(), ui->traceBox->isChecked());
 
-    vector<vector<int>> nextMove;
-    vector<vector<int>> removedTokens;
-    vector<vector<char>> currentState = game->getBoard()->getMatrix();
+    game->getAI()->clearStopRequest();
 
-    // Check whether AI is red or green
-    if (ui->redRadio->isChecked())
-        nextMove = game->getAI()->getNextMoveFromAI(ui->depthSlider->value() + 1, 'R', isMinimax, heuristicIndex);
-    else {
-        nextMove = game->getAI()->getNextMoveFromAI(ui->depthSlider->value() + 1, 'G', isMinimax, heuristicIndex);
+    emit searchRequested(game->getAI(), searchId, depthCap, aiColor, isMinimax, heuristicIndex, timeLimit);
+}
+
+/**
+ * @brief MainWindow::aiMoveFound, plays the AI move found on the worker thread and displays it
+ * @param id, the search the move comes from
+ * @param nextMove, the move, its captures are resolved
+ * @param elapsedMs, wall clock time the search took
+ */
+
+void MainWindow::aiMoveFound(int id, Move nextMove, qint64 elapsedMs) {
+    // The game was reset or restarted since this search began
+    if (!aiThinking || engineSearching || id != searchId)
+        return;
+
+    // The AI has no move left, the game ends without one
+    if (isNullMove(nextMove)) {
+        aiThinking = false;
+        monteCarloSearching = false;
+        setStopButtonEnabled(false);
+        disableAllButtons();
+
+        ui->messageText->append(QString::fromStdString(" >>> Player AI has no move left\n"
+                                                       " >>>\n >>> Game over - Player 1 wins\n"
+                                                       " >>> Press restart to play again"));
+        return;
     }
 
-    int x1 = nextMove[0][0];
-    int y1 = nextMove[0][1];
-    int x2 = nextMove[1][0];
-    int y2 = nextMove[1][1];
+    double elapsedTime = elapsedMs / 1000.0;
+    QString searchInfo;
+
+    if (monteCarloSearching) {
+        MCTSPlayer* mcts = game->getMCTS();
+        monteCarloSearching = false;
+
+        searchInfo = QString::fromStdString("\n >>> Time elapsed: ")
+                + QString::number(elapsedTime)
+                + QString::fromStdString("\n >>> Playouts: ")
+                + QString::number(mcts->getPlayoutCount())
+                + QString::fromStdString(" (")
+                + QString::number(qRound64(mcts->getPlayoutsPerSecond()))
+                + QString::fromStdString("/s), tree nodes: ")
+                + QString::number(mcts->getNodeCount())
+                + QString::fromStdString(", depth: ")
+                + QString::number(mcts->getCompletedDepth())
+                + QString::fromStdString("\n >>> Score: ")
+                + QString::number(mcts->getScore());
+
+        // Only alpha-beta records its tree
+        treeModel->setTrace(nullptr);
+        showSearchStats(mcts->getSearchStats());
+
+        playAIMove(nextMove, searchInfo);
+        return;
+    }
+
+    const TTCounters& hashCounters = game->getAI()->getHashCounters();
+    MoveOrderer* orderer = game->getAI()->getMoveOrderer();
+    int firstMoveCutoffRate = orderer->getCutoffs() == 0 ? 0
+            : int(100 * orderer->getFirstMoveCutoffs() / orderer->getCutoffs());
 
-    game->attack(x1, y1, x2, y2);
+    if (game->getAI()->wasPonderHit())
+        searchInfo += QString::fromStdString("\n >>> Reply pondered on your time");
+    else if (game->getAI()->getSearchStats().algorithm == "book")
+        searchInfo += QString::fromStdString("\n >>> Move from the opening book");
 
-    clock_t end = clock();
-    double elapsedTime = double(end - begin) / CLOCKS_PER_SEC;
+    searchInfo += QString::fromStdString("\n >>> Time elapsed: ")
+            + QString::number(elapsedTime)
+            + QString::fromStdString("\n >>> Search depth: ")
+            + QString::number(game->getAI()->getCompletedDepth())
+            + QString::fromStdString(", nodes: ")
+            + QString::number(game->getAI()->getNodeCount())
+            + QString::fromStdString(" (quiescence ")
+            + QString::number(game->getAI()->getQuiescenceNodeCount())
+            + QString::fromStdString(")")
+            + QString::fromStdString("\n >>> Principal variation: ")
+            + QString::fromStdString(lineName(game->getAI()->getPrincipalVariation()))
+            + QString::fromStdString("\n >>> Cutoffs on first move: ")
+            + QString::number(firstMoveCutoffRate)
+            + QString::fromStdString("%")
+            + QString::fromStdString("\n >>> Hash hits: ")
+            + QString::number(hashCounters.hits)
+            + QString::fromStdString("/")
+            + QString::number(hashCounters.probes)
+            + QString::fromStdString(", collisions: ")
+            + QString::number(hashCounters.collisions);
+
+    // Show the tree of the new move
+    treeModel->setTrace(game->getAI()->getSearchTrace());
+    showSearchStats(game->getAI()->getSearchStats());
+
+    playAIMove(nextMove, searchInfo);
+}
 
-    vector<vector<char>> newState = game->getBoard()->getMatrix();
+/**
+ * @brief MainWindow::engineMoveFound, plays the move of the engine process and displays it
+ * @param move, the move in the notation of the engine
+ * @param score, its score, green minus red
+ * @param depth, plies of the deepest iteration the engine completed
+ * @param nodes, nodes the engine searched
+ * @param elapsedMs, wall clock time the engine took
+ */
+
+void MainWindow::engineMoveFound(QString move, int score, int depth, qulonglong nodes, qint64 elapsedMs) {
+    if (!aiThinking || !engineSearching)
+        return;
+
+    engineSearching = false;
+
+    char aiColor = ui->redRadio->isChecked() ? 'R' : 'G';
+    Position position = game->getBoard()->getPosition();
+    Move nextMove;
+
+    if (!parseMove(position, move.toStdString(), nextMove)
+            || position.getValueAt(Position::getX(nextMove.from), Position::getY(nextMove.from)) != aiColor) {
+        engineFailed(QString::fromStdString("the engine played ") + move);
+        return;
+    }
 
-    // Check whether AI is red or green
-    if (ui->redRadio->isChecked())
-        removedTokens = game->getBoard()->getRemovedTokens(currentState, newState, 'R');
+    QString searchInfo = QString::fromStdString("\n >>> Time elapsed: ")
+            + QString::number(elapsedMs / 1000.0)
+            + QString::fromStdString("\n >>> Search depth: ")
+            + QString::number(depth)
+            + QString::fromStdString(", nodes: ")
+            + QString::number(nodes)
+            + QString::fromStdString("\n >>> Score: ")
+            + QString::number(score);
+
+    // The engine keeps no tree, and reports only part of the statistics
+    treeModel->setTrace(nullptr);
+
+    SearchStats stats;
+    stats.algorithm = getAlgorithmName().toStdString();
+    stats.heuristicIndex = getHeuristicIndex();
+    stats.side = aiColor;
+    stats.move = moveName(nextMove);
+    stats.score = score;
+    stats.depth = depth;
+    stats.ms = elapsedMs;
+    stats.nodes = nodes;
+    showSearchStats(stats);
+
+    playAIMove(nextMove, searchInfo);
+}
+
+/**
+ * @brief MainWindow::engineInfo, logs the progress of the engine process while it searches
+ * @param line, an info line of the engine
+ */
+
+void MainWindow::engineInfo(QString line) {
+    if (aiThinking && engineSearching)
+        ui->messageText->append(QString::fromStdString(" >>> ") + line);
+}
+
+/**
+ * @brief MainWindow::engineFailed, searches the move in the game when the engine process
+ *        could not answer
+ * @param reason, what went wrong
+ */
+
+void MainWindow::engineFailed(QString reason) {
+    if (!aiThinking || !engineSearching)
+        return;
+
+    engineSearching = false;
+    ui->messageText->append(QString::fromStdString(" >>> Engine process failed, ") + reason
+                            + QString::fromStdString(", the AI searches in the game"));
+
+    searchInProcess();
+}
+
+/**
+ * @brief MainWindow::showSearchStats, shows the statistics of an AI move in the stats
+ *        panel and appends them to the stats log as a line of JSON, while statsBox is checked
+ * @param stats, the statistics of the search that found the move
+ */
+
+void MainWindow::showSearchStats(const SearchStats& stats) {
+    if (!ui->statsBox->isChecked())
+        return;
+
+    QString text = QString::fromStdString("Move ") + QString::fromStdString(stats.move)
+            + QString::fromStdString(" (") + QString::fromStdString(stats.algorithm)
+            + QString::fromStdString(stats.algorithm == "mcts" ? "" : ", heuristic " + std::to_string(stats.heuristicIndex))
+            + QString::fromStdString(stats.ponderHit ? ", pondered)" : ")")
+            + QString::fromStdString("\nScore ") + QString::number(stats.score)
+            + QString::fromStdString(", depth ") + QString::number(stats.depth)
+            + QString::fromStdString(", ") + QString::number(qRound64(stats.ms)) + QString::fromStdString(" ms")
+            + QString::fromStdString("\nNodes ") + QString::number(stats.nodes);
+
+    if (stats.algorithm == "mcts") {
+        text += QString::fromStdString("\nPlayouts ") + QString::number(stats.playouts)
+                + QString::fromStdString(" (") + QString::number(stats.ms > 0 ? qRound64(stats.playouts * 1000 / stats.ms) : 0)
+                + QString::fromStdString("/s)");
+    }
     else {
-        removedTokens = game->getBoard()->getRemovedTokens(currentState, newState, 'G');
+        text += QString::fromStdString(" (quiescence ") + QString::number(stats.quiescenceNodes)
+                + QString::fromStdString(")\nLeaf evaluations ") + QString::number(stats.leafEvaluations)
+                + QString::fromStdString("\nBeta cutoffs ") + QString::number(stats.cutoffs)
+                + QString::fromStdString(", by move:\n ");
+
+        for (int i = 0; i < CUTOFF_SLOTS; i++) {
+            int rate = stats.cutoffs == 0 ? 0 : int(100 * stats.cutoffsAtMove[i] / stats.cutoffs);
+            text += QString::fromStdString(i == CUTOFF_SLOTS - 1 ? " " + std::to_string(i + 1) + "+:" : " " + std::to_string(i + 1) + ":")
+                    + QString::number(rate) + QString::fromStdString("%");
+        }
+
+        text += QString::fromStdString("\nHash hits ") + QString::number(stats.hashHits)
+                + QString::fromStdString("/") + QString::number(stats.hashProbes)
+                + QString::fromStdString("\nRe-searches ") + QString::number(stats.researches)
+                + QString::fromStdString("\nBranching factor ") + QString::number(stats.getBranchingFactor(), 'f', 2)
+                + QString::fromStdString("\nTrace memory ") + QString::number(qulonglong(stats.tracePeakBytes / 1024))
+                + QString::fromStdString(" KB\n\nDepth      Nodes        ms");
+
+        for (const IterationStats& iteration : stats.iterations)
+            text += QString::fromStdString("\n") + QString::number(iteration.depth).rightJustified(5)
+                    + QString::number(iteration.nodes).rightJustified(11)
+                    + QString::number(iteration.ms, 'f', 1).rightJustified(10);
     }
 
-    setRemovedTokensColors(removedTokens);
+    statsLabel->setText(text);
+
+    // One move per line, appended across games
+    QFile log(getStatsLogPath());
+
+    if (log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        QTextStream stream(&log);
+        stream << QString::fromStdString(statsLine(stats)) << "\n";
+    }
+    else
+        ui->messageText->append(QString::fromStdString(" >>> Cannot write the stats log ") + log.fileName());
+}
+
+/**
+ * @brief MainWindow::getStatsLogPath, the log the statistics of the AI moves are appended
+ *        to, set with the BONZEE_STATS_LOG environment variable, next to the game otherwise
+ * @return the path of the log
+ */
+
+QString MainWindow::getStatsLogPath() {
+    QString path = QString::fromLocal8Bit(qgetenv("BONZEE_STATS_LOG"));
+
+    if (!path.isEmpty())
+        return path;
+
+    return QCoreApplication::applicationDirPath() + QString::fromStdString("/bonzee-stats.jsonl");
+}
+
+/**
+ * @brief MainWindow::getTablebasePath, the directory of the endgame tables written by tbgen, set
+ *        with the BONZEE_TABLEBASE environment variable, next to the game otherwise
+ * @return the path of the directory
+ */
+
+QString MainWindow::getTablebasePath() {
+    QString path = QString::fromLocal8Bit(qgetenv("BONZEE_TABLEBASE"));
+
+    if (!path.isEmpty())
+        return path;
+
+    return QCoreApplication::applicationDirPath() + QString::fromStdString("/tablebase");
+}
+
+/**
+ * @brief MainWindow::getOpeningBookPath, the opening book written by bookgen, set with the
+ *        BONZEE_BOOK environment variable, next to the game otherwise
+ * @return the path of the book
+ */
+
+QString MainWindow::getOpeningBookPath() {
+    QString path = QString::fromLocal8Bit(qgetenv("BONZEE_BOOK"));
+
+    if (!path.isEmpty())
+        return path;
+
+    return QCoreApplication::applicationDirPath() + QString::fromStdString("/book.bzbk");
+}
+
+/**
+ * @brief MainWindow::playAIMove, plays the move of the AI, logs it and highlights it
+ * @param nextMove, the move, its captures are resolved
+ * @param searchInfo, statistics of the search that found it
+ */
+
+void MainWindow::playAIMove(const Move& nextMove, const QString& searchInfo) {
+    aiThinking = false;
+    setStopButtonEnabled(false);
+
+    int x1 = Position::getX(nextMove.from);
+    int y1 = Position::getY(nextMove.from);
+    int x2 = Position::getX(nextMove.to);
+    int y2 = Position::getY(nextMove.to);
+
+    game->performMove(nextMove);
+
+    setRemovedTokensColors(nextMove);
 
     // Display AI move in log
     QString message = QString::fromStdString(" >>> Player AI moves token ")
             + buttonNames[x1][y1]
             + QString::fromStdString(" to ")
-            + buttonNames[x2][y2]
-            + QString::fromStdString("\n >>> Time elapsed: ")
-            + QString::number(elapsedTime)
+            + buttonNames[x2][y2];
+
+    if (nextMove.captureCount > 0)
+        message += QString::fromStdString(", captures ") + QString::number(nextMove.captureCount);
+
+    message += searchInfo
             + QString::fromStdString("\n >>>\n >>> Player 1 turn");
 
     ui->messageText->append(message);
 
-    // Clear and repopulate AI tree
-    ui->tree->clear();
-    game->getAI()->setTree(ui->tree);
-
     if (game->getBoard()->getTileColor(x1, y1)) {
         gameButtons[x1][y1]->setStyleSheet("QPushButton{"
                               "  background: white;"
@@ -631,18 +1054,129 @@ void MainWindow::performAITurn() {
                               "  border: 5px solid #E06104;"
                               "}");
     }
+
+    updateBoard();
+    updateInformation();
+
+    // Think on the human's time until they move, the engine process and MCTS do not ponder
+    if (ui->ponderBox->isChecked() && !ui->engineBox->isChecked() && !ui->algoRadio_3->isChecked()
+            && !game->checkGameOver())
+        startPondering();
+}
+
+/**
+ * @brief MainWindow::moveNow, stops the AI search, it plays the best move found so far
+ */
+
+void MainWindow::moveNow() {
+    if (aiThinking && engineSearching)
+        engine->stop();
+    else if (aiThinking)
+        stopSearch();
+}
+
+/**
+ * @brief MainWindow::stopSearch, stops the search of the game running on the worker thread
+ */
+
+void MainWindow::stopSearch() {
+    if (monteCarloSearching)
+        game->getMCTS()->stopSearch();
+    else
+        game->getAI()->stopSearch();
+}
+
+/**
+ * @brief MainWindow::getHeuristicIndex, the heuristic chosen in the AI options
+ * @return 0 = naive, 1 = counting, 2 = informed
+ */
+
+int MainWindow::getHeuristicIndex() {
+    if (ui->heuristicRadio_2->isChecked())
+        return 1;
+    else if (ui->heuristicRadio_3->isChecked())
+        return 2;
+    else
+        return 0;
+}
+
+/**
+ * @brief MainWindow::getAlgorithmName, the algorithm chosen in the AI options
+ * @return its name in the engine protocol, minimax, alphabeta or mcts
+ */
+
+QString MainWindow::getAlgorithmName() {
+    if (ui->algoRadio_1->isChecked())
+        return QString::fromStdString("minimax");
+    else if (ui->algoRadio_3->isChecked())
+        return QString::fromStdString("mcts");
+    else
+        return QString::fromStdString("alphabeta");
+}
+
+/**
+ * @brief MainWindow::startPondering, lets the AI search replies to the human's likely
+ *        moves on the worker thread until the human moves
+ */
+
+void MainWindow::startPondering() {
+    char aiColor = ui->redRadio->isChecked() ? 'R' : 'G';
+
+    aiPondering = true;
+    ponderId++;
+
+    emit ponderRequested(game->getAI(), game->getBoard()->getPosition(), ponderId,
+                         ui->depthSlider->value() + 1, aiColor,
+                         ui->algoRadio_1->isChecked(), getHeuristicIndex());
+}
+
+/**
+ * @brief MainWindow::stopPondering, ends the ponder, the worker is free for the next search
+ */
+
+void MainWindow::stopPondering() {
+    if (!aiPondering)
+        return;
+
+    game->getAI()->stopPondering(ponderId);
+    aiPondering = false;
+}
+
+/**
+ * @brief MainWindow::setStopButtonEnabled, enables the move now button while the AI thinks
+ * @param enabled, whether the AI is thinking
+ */
+
+void MainWindow::setStopButtonEnabled(bool enabled) {
+    ui->stopButton->setEnabled(enabled);
+
+    if (enabled)
+        ui->stopButton->setStyleSheet("QPushButton{"
+                                      "  border:1px solid green;"
+                                      "  color:green;"
+                                      "}"
+                                      "QPushButton::hover{"
+                                      "  background:gray;"
+                                      "  color:black;"
+                                      "}");
+    else
+        ui->stopButton->setStyleSheet("QPushButton{"
+                                      "  border:1px solid gray;"
+                                      "  color:gray;"
+                                      "}");
 }
 
 /**
  * @brief MainWindow::displayMove, displays player move in the log
- * @param x1, original x coordinate
- * @param y1, original y coordinate
- * @param x2, destination x coordinate
- * @param y2, destination y coordinate
+ * @param move, the move played, its captures are listed when there are any
  */
 
-void MainWindow::displayMove(int x1, int y1, int x2, int y2) {
+void MainWindow::displayMove(const Move& move) {
     QString message;
+    int x1 = Position::getX(move.from);
+    int y1 = Position::getY(move.from);
+    int x2 = Position::getX(move.to);
+    int y2 = Position::getY(move.to);
 
     if (game->getTurn()) {
         message = QString::fromStdString(" >>> Player 1 moves token ");
@@ -657,6 +1191,9 @@ void MainWindow::displayMove(int x1, int y1, int x2, int y2) {
         message += buttonNames[x2][y2];
     }
 
+    if (move.captureCount > 0)
+        message += QString::fromStdString(", captures ") + QString::number(move.captureCount);
+
     ui->messageText->append(message);
 }
 
@@ -762,20 +1299,24 @@ void MainWindow::setMenuButtonsColors(bool isStart) {
         ui->colorLabel->setStyleSheet("color:green;"
                                       "border:0px;");
         ui->messageText->clear();
-        ui->tree->clear();
+        treeModel->setTrace(nullptr);
     }
 }
 
 /**
  * @brief MainWindow::setRemovedTokensColors, sets the color of removed token as a result of a given move
- * @param removedTokens, a list of all removed tokens
+ * @param move, the move that removed the tokens
  */
 
-void MainWindow::setRemovedTokensColors(vector<vector<int>> removedTokens) {
-    for (unsigned int i = 0; i < removedTokens.size(); i++) {
+void MainWindow::setRemovedTokensColors(const Move& move) {
+    uint64_t removedTokens = move.captured;
+
+    while (removedTokens) {
+        int square = firstSquare(removedTokens);
+        removedTokens &= removedTokens - 1;
 
-        int x = removedTokens[i][0];
-        int y = removedTokens[i][1];
+        int x = Position::getX(square);
+        int y = Position::getY(square);
 
         if (game->getBoard()->getTileColor(x, y)) {
             gameButtons[x][y]->setStyleSheet("QPushButton{"
@@ -8,12 +8,18 @@
 #include <QMovie>
 #include <QDialog>
 #include <QThread>
+#include <QDockWidget>
+#include <QLabel>
 #include <vector>
 #include <iostream>
 #include <sstream>
 #include <ctime>
 
 #include "game.h"
+#include "aiworker.h"
+#include "searchtreemodel.h"
+#include "engineprocess.h"
+#include "notation.h"
 
 using namespace std;
 
@@ -40,6 +46,20 @@ private:
     bool part_1;
     bool firstStart;
     std::vector<int> savedCoordinates;
+    QThread* aiThread; //The AI searches here, off the GUI thread
+    AIWorker* aiWorker;
+    bool aiThinking; //Board input is locked while true
+    int searchId; //Results of an older search are dropped
+    bool aiPondering; //The AI searches on the human's time
+    int ponderId;
+    SearchTreeModel* treeModel; //Rows of the AI tree are built when expanded
+    EngineProcess* engine; //Searches in a separate process when chosen
+    bool engineSearching;
+    bool monteCarloSearching; //The move comes from the MCTS player
+    QDockWidget* statsDock; //Statistics of the last AI move, shown while statsBox is checked
+    QLabel* statsLabel;
+    shared_ptr<const Tablebase> tablebase; //Endgame tables, mapped when the first game with the AI starts
+    shared_ptr<const OpeningBook> openingBook; //Opening book, mapped with the tables
 
     void updateBoard();
     void setButtonsColor();
@@ -50,10 +70,29 @@ private:
     void displayPlayerTurn();
     void setClickedButtonColor(int x, int y);
     void performAITurn();
-    void displayMove(int x1, int y1, int x2, int y2);
+    void searchInProcess();
+    void playAIMove(const Move& nextMove, const QString& searchInfo);
+    void showSearchStats(const SearchStats& stats);
+    static QString getStatsLogPath();
+    static QString getTablebasePath();
+    static QString getOpeningBookPath();
+    void displayMove(const Move& move);
     void setAdjacentColors(int x, int y);
     void setMenuButtonsColors(bool isStart);
-    void setRemovedTokensColors(vector<vector<int>> removedTokens);
+    void setRemovedTokensColors(const Move& move);
+    void setStopButtonEnabled(bool enabled);
+    int getHeuristicIndex();
+    QString getAlgorithmName();
+    void stopSearch();
+    void startPondering();
+    void stopPondering();
+
+signals:
+    void configureRequested(AIPlayer* ai, int threadCount, bool tracing);
+    void searchRequested(AIPlayer* ai, int searchId, int level, char currentPlayer, bool isMinimax, int heuristicIndex, int timeLimitMs);
+    void ponderRequested(AIPlayer* ai, Position start, int ponderId, int level, char currentPlayer, bool isMinimax, int heuristicIndex);
+    void monteCarloRequested(MCTSPlayer* mcts, int searchId, char currentPlayer, int threadCount, int timeLimitMs);
+    void releaseRequested(Game* game);
 
 private slots:
     void gameButtonClicked();
@@ -62,6 +101,11 @@ private slots:
     void clearMessages();
     void expand();
     void collapse();
+    void aiMoveFound(int id, Move nextMove, qint64 elapsedMs);
+    void engineMoveFound(QString move, int score, int depth, qulonglong nodes, qint64 elapsedMs);
+    void engineInfo(QString line);
+    void engineFailed(QString reason);
+    void moveNow();
 };
 
 #endif // MAINWINDOW_H
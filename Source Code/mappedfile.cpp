@@ -0,0 +1,103 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data(nullptr), size(0)
+#ifdef _WIN32
+    , mapping(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/**
+ * @brief MappedFile::open, maps a file read-only, the file itself is closed again
+ *        at once, the mapping keeps it open until close
+ * @param path, the file
+ * @return whether the file is mapped
+ */
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (mapping == nullptr)
+        return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        mapping = nullptr;
+        return false;
+    }
+
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+
+    if (file < 0)
+        return false;
+
+    struct stat status;
+
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        ::close(file);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+
+    if (view == MAP_FAILED)
+        return false;
+
+    size = static_cast<size_t>(status.st_size);
+#endif
+
+    data = static_cast<const uint8_t*>(view);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+    mapping = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(data), size);
+#endif
+
+    data = nullptr;
+    size = 0;
+}
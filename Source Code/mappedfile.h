@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* A file mapped read-only into memory. The tablebases and the opening book
+ * are read in place this way: the system pages in what the search touches
+ * and several processes playing at once share one copy of the data. */
+class MappedFile
+{
+private:
+    const uint8_t* data;
+    size_t size;
+#ifdef _WIN32
+    void* mapping; //Handle of the file mapping object
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // maps the whole file, a file already mapped is closed first;
+    // false when it cannot be opened or is empty
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const uint8_t* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
+
+#endif // MAPPEDFILE_H
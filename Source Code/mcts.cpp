@@ -0,0 +1,417 @@
+#include "mcts.h"
+#include "game.h"
+#include "notation.h"
+#include <cmath>
+#include <vector>
+
+// Node states, a leaf is expanded by the first thread that claims it
+const uint8_t NODE_LEAF = 0;
+const uint8_t NODE_EXPANDING = 1;
+const uint8_t NODE_EXPANDED = 2;
+
+// xorshift64*, each thread keeps its own state
+static inline uint32_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+
+    return static_cast<uint32_t>((state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+MCTSPlayer::MCTSPlayer(Board *current_board) : board(current_board), rootPlayer('G'),
+    poolUsed(0), threadCount(1), parallelism(MCTS_TREE_PARALLEL), treeCount(1),
+    timeLimited(false), playoutLimit(0), playoutCap(0), stopRequested(false), searchStopped(false),
+    playouts(0), deepestPath(0), totalPlayouts(0), elapsedMs(0), score(0), depth(0)
+{
+    roots.resize(1);
+}
+
+MCTSPlayer::~MCTSPlayer()
+{
+}
+
+/**
+ * @brief MCTSPlayer::allocateNode, takes a fresh node from the pool
+ * @return its index, -1 when the pool is used up
+ */
+
+int MCTSPlayer::allocateNode(const Move& move) {
+    uint32_t index = poolUsed.fetch_add(1, memory_order_relaxed);
+
+    if (index >= static_cast<uint32_t>(MCTS_POOL_NODES))
+        return -1;
+
+    MCTSNode& node = pool[index];
+    node.move = move;
+    node.firstChild = -1;
+    node.childCount = 0;
+    node.state.store(NODE_LEAF, memory_order_relaxed);
+    node.visits.store(0, memory_order_relaxed);
+    node.score.store(0, memory_order_relaxed);
+
+    return static_cast<int>(index);
+}
+
+/**
+ * @brief MCTSPlayer::expand, gives a leaf one child per move of the side to move
+ * @param node, the leaf, left alone when another thread is expanding it already
+ * @param state, the position of the leaf
+ * @param player, the side to move
+ * @return whether this thread expanded the node
+ */
+
+bool MCTSPlayer::expand(int node, const Position& state, char player) {
+    uint8_t leaf = NODE_LEAF;
+
+    if (poolUsed.load(memory_order_relaxed) >= static_cast<uint32_t>(MCTS_POOL_NODES)
+            || !pool[node].state.compare_exchange_strong(leaf, NODE_EXPANDING, memory_order_acquire))
+        return false;
+
+    Move moves[MAX_MOVES];
+    int moveCount = state.generateMoves(player, moves);
+    uint32_t first = poolUsed.fetch_add(moveCount, memory_order_relaxed);
+
+    // the pool ran out, the node stays a leaf for good
+    if (first + moveCount > static_cast<uint32_t>(MCTS_POOL_NODES)) {
+        pool[node].state.store(NODE_LEAF, memory_order_release);
+        return false;
+    }
+
+    for (int i = 0; i < moveCount; i++) {
+        MCTSNode& child = pool[first + i];
+        child.move = moves[i];
+        child.firstChild = -1;
+        child.childCount = 0;
+        child.state.store(NODE_LEAF, memory_order_relaxed);
+        child.visits.store(0, memory_order_relaxed);
+        child.score.store(0, memory_order_relaxed);
+    }
+
+    pool[node].firstChild = static_cast<int32_t>(first);
+    pool[node].childCount = moveCount;
+    pool[node].state.store(NODE_EXPANDED, memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief MCTSPlayer::selectChild, picks the child with the highest upper confidence
+ *        bound (UCT), a child nobody has visited yet comes first
+ * @param node, an expanded node with children
+ */
+
+int MCTSPlayer::selectChild(int node) const {
+    const MCTSNode& parent = pool[node];
+    double logVisits = log(static_cast<double>(max(1u, parent.visits.load(memory_order_relaxed))));
+    int best = parent.firstChild;
+    double bestValue = -1;
+
+    for (int i = parent.firstChild; i < parent.firstChild + parent.childCount; i++) {
+        uint32_t visits = pool[i].visits.load(memory_order_relaxed);
+
+        if (visits == 0)
+            return i;
+
+        double value = pool[i].score.load(memory_order_relaxed) / (2.0 * visits)
+                + MCTS_EXPLORATION * sqrt(logVisits / visits);
+
+        if (value > bestValue) {
+            bestValue = value;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief materialWinner, scores a game that stalled: nearly every playout ends
+ *        in a stalemate, so the side with more tokens left counts as the winner
+ * @return the side ahead, 'D' when the counts are even
+ */
+
+static char materialWinner(const Position& state) {
+    int green = state.getTokenAmount('G');
+    int red = state.getTokenAmount('R');
+
+    return green > red ? 'G' : (red > green ? 'R' : 'D');
+}
+
+/**
+ * @brief MCTSPlayer::playout, plays random moves until the game ends, captures first
+ * @param state, played on, the position the playout starts from
+ * @param player, the side to move
+ * @param quietMoves, moves without a capture so far, the game is drawn at STALEMATE_MOVES
+ * @param random, state of the thread's random numbers
+ * @return the winner, 'D' for a draw, a stalled game goes to the side with more tokens
+ */
+
+char MCTSPlayer::playout(Position& state, char player, int quietMoves, uint64_t& random) const {
+    Move moves[MAX_MOVES];
+
+    for (int ply = 0; ply < MCTS_PLAYOUT_PLIES; ply++) {
+        if (state.getTokens('R') == 0)
+            return 'G';
+
+        if (state.getTokens('G') == 0)
+            return 'R';
+
+        int moveCount = state.generateMoves(player, moves);
+
+        if (quietMoves >= STALEMATE_MOVES || moveCount == 0)
+            return materialWinner(state);
+
+        // random play hardly ever captures before the game is drawn,
+        // so a capture is taken whenever there is one
+        int captureCount = 0;
+
+        for (int i = 0; i < moveCount; i++)
+            if (moves[i].captureCount > 0)
+                moves[captureCount++] = moves[i];
+
+        if (captureCount > 0)
+            moveCount = captureCount;
+
+        const Move& move = moves[(static_cast<uint64_t>(nextRandom(random)) * moveCount) >> 32];
+        state.applyMove(move);
+        quietMoves = move.captureCount > 0 ? 0 : quietMoves + 1;
+        player = player == 'G' ? 'R' : 'G';
+    }
+
+    return materialWinner(state);
+}
+
+/**
+ * @brief MCTSPlayer::searchTree, runs playouts from the root until a limit is reached:
+ *        select down the tree, expand the leaf if it was visited before, play out
+ *        from it and add the result to every node of the path
+ * @param rootNode, root of the tree the thread grows
+ * @param threadIndex, seeds the thread's random numbers
+ */
+
+void MCTSPlayer::searchTree(int rootNode, int threadIndex) {
+    uint64_t random = 0x9E3779B97F4A7C15ULL * (threadIndex + 1);
+    char opponent = rootPlayer == 'G' ? 'R' : 'G';
+    int path[MCTS_MAX_DEPTH + 2];
+
+    while (!searchStopped.load(memory_order_relaxed)) {
+        Position state = root;
+        char player = rootPlayer;
+        int quietMoves = 0;
+        int node = rootNode;
+        int length = 0;
+
+        // a visit counts before its result is known, a virtual loss
+        // that sends the other threads of the tree down other paths
+        pool[node].visits.fetch_add(1, memory_order_relaxed);
+        path[length++] = node;
+
+        while (length <= MCTS_MAX_DEPTH) {
+            bool gameOver = state.getTokens('R') == 0 || state.getTokens('G') == 0 || quietMoves >= STALEMATE_MOVES;
+            uint8_t nodeState = pool[node].state.load(memory_order_acquire);
+
+            // a leaf visited before gets its children, the playout starts below it
+            if (!gameOver && nodeState == NODE_LEAF && pool[node].visits.load(memory_order_relaxed) > 1
+                    && expand(node, state, player))
+                nodeState = NODE_EXPANDED;
+
+            if (gameOver || nodeState != NODE_EXPANDED || pool[node].childCount == 0)
+                break;
+
+            node = selectChild(node);
+            uint32_t visited = pool[node].visits.fetch_add(1, memory_order_relaxed);
+            path[length++] = node;
+
+            const Move& move = pool[node].move;
+            state.applyMove(move);
+            quietMoves = move.captureCount > 0 ? 0 : quietMoves + 1;
+            player = player == 'G' ? 'R' : 'G';
+
+            // a node reached for the first time is played out from at once
+            if (visited == 0)
+                break;
+        }
+
+        char winner = playout(state, player, quietMoves, random);
+
+        // the root is reached by the opponent's move, every other ply alternates
+        for (int i = 0; i < length; i++) {
+            char mover = i % 2 == 0 ? opponent : rootPlayer;
+            uint32_t points = winner == mover ? 2 : (winner == 'D' ? 1 : 0);
+
+            if (points > 0)
+                pool[path[i]].score.fetch_add(points, memory_order_relaxed);
+        }
+
+        int deepest = deepestPath.load(memory_order_relaxed);
+
+        while (length - 1 > deepest && !deepestPath.compare_exchange_weak(deepest, length - 1, memory_order_relaxed)) {
+        }
+
+        uint64_t count = playouts.fetch_add(1, memory_order_relaxed) + 1;
+
+        if ((playoutCap != 0 && count >= playoutCap) || stopRequested.load(memory_order_relaxed)
+                || (timeLimited && (count & 15) == 0 && chrono::steady_clock::now() >= deadline))
+            searchStopped.store(true, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief MCTSPlayer::runHelper, the task of a helper thread, grows its tree until the search stops
+ * @param context, the player
+ * @param worker, index of the helper, thread worker + 1 of the search
+ */
+
+void MCTSPlayer::runHelper(void* context, int worker) {
+    MCTSPlayer* player = static_cast<MCTSPlayer*>(context);
+    int thread = worker + 1;
+
+    player->searchTree(player->roots[player->treeCount == 1 ? 0 : thread], thread);
+}
+
+/**
+ * @brief MCTSPlayer::getNextMoveFromMCTS, searches the game board with Monte Carlo tree
+ *        search, on the threads set with setThreadCount
+ * @param currentPlayer, the side the AI plays
+ * @param timeLimitMs, wall clock budget in milliseconds, 0 = no limit
+ * @return the root move with the most visits
+ */
+
+Move MCTSPlayer::getNextMoveFromMCTS(char currentPlayer, int timeLimitMs) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    root = board->getPosition();
+    rootPlayer = currentPlayer;
+
+    if (!pool)
+        pool.reset(new MCTSNode[MCTS_POOL_NODES]);
+
+    poolUsed.store(0, memory_order_relaxed);
+    playouts.store(0, memory_order_relaxed);
+    deepestPath.store(0, memory_order_relaxed);
+    searchStopped.store(false, memory_order_relaxed);
+    deadline = start + chrono::milliseconds(timeLimitMs);
+    timeLimited = timeLimitMs > 0;
+    playoutCap = playoutLimit != 0 || timeLimited ? playoutLimit : MCTS_DEFAULT_PLAYOUTS;
+
+    Move moves[MAX_MOVES];
+    int moveCount = root.generateMoves(currentPlayer, moves);
+
+    // every tree starts expanded so the root moves line up between the trees
+    int trees = parallelism == MCTS_ROOT_PARALLEL ? threadCount : 1;
+    treeCount = trees;
+
+    for (int i = 0; i < trees; i++) {
+        roots[i] = allocateNode(Move());
+        expand(roots[i], root, currentPlayer);
+    }
+
+    if (moveCount > 1) {
+        helperThreads.run(&MCTSPlayer::runHelper, this);
+        searchTree(roots[0], 0);
+        helperThreads.wait();
+    }
+
+    // the move played most often is the one the search trusts most
+    int best = 0;
+    uint64_t bestVisits = 0;
+    uint64_t bestScore = 0;
+
+    for (int i = 0; i < moveCount; i++) {
+        uint64_t visits = 0;
+        uint64_t points = 0;
+
+        for (int tree = 0; tree < trees; tree++) {
+            const MCTSNode& child = pool[pool[roots[tree]].firstChild + i];
+            visits += child.visits.load(memory_order_relaxed);
+            points += child.score.load(memory_order_relaxed);
+        }
+
+        if (visits > bestVisits || (visits == bestVisits && points > bestScore)) {
+            best = i;
+            bestVisits = visits;
+            bestScore = points;
+        }
+    }
+
+    // no move left, the AI has lost and there is nothing to play
+    Move bestMove = moveCount > 0 ? moves[best] : NULL_MOVE;
+
+    // half points of the move for the AI, turned into green minus red
+    double expected = moveCount == 0 ? 0 : bestVisits > 0 ? bestScore / (2.0 * bestVisits) : 0.5;
+    score = static_cast<int>(lround((2 * expected - 1) * 100));
+
+    if (currentPlayer == 'R')
+        score = -score;
+
+    totalPlayouts = playouts.load(memory_order_relaxed);
+    depth = deepestPath.load(memory_order_relaxed);
+    elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    searchStats.algorithm = "mcts";
+    searchStats.side = currentPlayer;
+    searchStats.move = moveName(bestMove);
+    searchStats.score = score;
+    searchStats.depth = depth;
+    searchStats.ms = elapsedMs;
+    searchStats.nodes = getNodeCount();
+    searchStats.playouts = totalPlayouts;
+
+    return bestMove;
+}
+
+uint64_t MCTSPlayer::getPlayoutCount() {
+    return totalPlayouts;
+}
+
+double MCTSPlayer::getPlayoutsPerSecond() {
+    return elapsedMs > 0 ? totalPlayouts * 1000.0 / elapsedMs : 0;
+}
+
+uint64_t MCTSPlayer::getNodeCount() {
+    return min(poolUsed.load(memory_order_relaxed), static_cast<uint32_t>(MCTS_POOL_NODES));
+}
+
+int MCTSPlayer::getCompletedDepth() {
+    return depth;
+}
+
+int MCTSPlayer::getScore() {
+    return score;
+}
+
+const SearchStats& MCTSPlayer::getSearchStats() {
+    return searchStats;
+}
+
+void MCTSPlayer::stopSearch() {
+    stopRequested.store(true, memory_order_relaxed);
+}
+
+void MCTSPlayer::clearStopRequest() {
+    stopRequested.store(false, memory_order_relaxed);
+}
+
+void MCTSPlayer::setPlayoutLimit(uint64_t limit) {
+    playoutLimit = limit;
+}
+
+void MCTSPlayer::setThreadCount(int threads) {
+    threadCount = max(1, threads);
+    roots.resize(threadCount);
+
+    if (helperThreads.getSize() != threadCount - 1)
+        helperThreads.resize(threadCount - 1);
+}
+
+int MCTSPlayer::getThreadCount() {
+    return threadCount;
+}
+
+void MCTSPlayer::setParallelism(int mode) {
+    parallelism = mode == MCTS_ROOT_PARALLEL ? MCTS_ROOT_PARALLEL : MCTS_TREE_PARALLEL;
+}
+
+int MCTSPlayer::getParallelism() {
+    return parallelism;
+}
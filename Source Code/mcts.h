@@ -0,0 +1,123 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "board.h"
+#include "searchstats.h"
+#include "workerpool.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Ways the threads of a Monte Carlo search share the work
+const int MCTS_TREE_PARALLEL = 0; //All threads grow one tree, the visits a thread is still
+                                  //playing out count as losses so the others look elsewhere
+const int MCTS_ROOT_PARALLEL = 1; //Each thread grows its own tree from the root, the visits
+                                  //of the root moves are summed over the trees
+
+// Nodes of the pool, allocated once and reused by every search
+const int MCTS_POOL_NODES = 1 << 20;
+// Playouts of a search without a time or playout limit
+const uint64_t MCTS_DEFAULT_PLAYOUTS = 20000;
+// Moves a playout makes before it is scored as a draw
+const int MCTS_PLAYOUT_PLIES = 200;
+// Deepest path from the root the selection follows
+const int MCTS_MAX_DEPTH = 128;
+// Weight of the exploration term of UCT, results are scored 0 to 1, about 1/sqrt(2)
+const double MCTS_EXPLORATION = 0.7;
+
+/* A node of the search tree, the position after move. Children are a range
+ * of the pool filled when the node is expanded; visits and score are
+ * updated by all threads without locks. The score is counted in half
+ * points for the side that played move: 2 per win, 1 per draw. */
+struct MCTSNode {
+    Move move;
+    int32_t firstChild;
+    int32_t childCount;
+    std::atomic<uint8_t> state; //Leaf, being expanded by a thread or expanded
+    std::atomic<uint32_t> visits;
+    std::atomic<uint32_t> score;
+};
+
+class MCTSPlayer{
+private:
+    Board* board; //Refers to the current game
+    Position root; //Position the search starts from
+    char rootPlayer;
+
+    // arena of nodes, the search takes ranges of it with one atomic add
+    unique_ptr<MCTSNode[]> pool;
+    atomic<uint32_t> poolUsed;
+    vector<int> roots; //Root of each tree, one per thread when root-parallel
+
+    int threadCount;
+    int parallelism;
+    WorkerPool helperThreads; //Threads beside the calling one, started by setThreadCount
+    int treeCount; //Trees of the running search
+
+    // limits, the clock is read every few playouts
+    chrono::steady_clock::time_point deadline;
+    bool timeLimited;
+    uint64_t playoutLimit; //Playouts per move, 0 = no limit
+    uint64_t playoutCap; //Playouts of the running search, 0 = until the time is up
+    atomic<bool> stopRequested; //Set from the GUI thread to play the best move found so far
+    atomic<bool> searchStopped; //Set by the first thread that reaches a limit
+    atomic<uint64_t> playouts;
+    atomic<int> deepestPath;
+
+    // result of the last search
+    uint64_t totalPlayouts;
+    double elapsedMs;
+    int score;
+    int depth;
+    SearchStats searchStats;
+
+    int allocateNode(const Move& move);
+    bool expand(int node, const Position& state, char player);
+    int selectChild(int node) const;
+    char playout(Position& state, char player, int quietMoves, uint64_t& random) const;
+    void searchTree(int rootNode, int threadIndex);
+    static void runHelper(void* context, int worker);
+
+public:
+    MCTSPlayer(Board* current_board);
+    ~MCTSPlayer();
+
+    // return the move played most often from the game board by the
+    // search, which runs until timeLimitMs runs out (0 = no limit)
+    // or the playout limit is reached, whichever comes first
+    Move getNextMoveFromMCTS(char currentPlayer, int timeLimitMs = 0);
+
+    // playouts of the last search, per second, the nodes of its
+    // tree, its deepest path in plies and the expected result
+    // of the move played from 100 (green wins) to -100 (red wins)
+    uint64_t getPlayoutCount();
+    double getPlayoutsPerSecond();
+    uint64_t getNodeCount();
+    int getCompletedDepth();
+    int getScore();
+
+    // the same figures as a statistics record, see searchstats.h
+    const SearchStats& getSearchStats();
+
+    // may be called from any thread while the search runs,
+    // the request holds until cleared like AIPlayer's
+    void stopSearch();
+    void clearStopRequest();
+
+    // playouts per move, 0 = no limit; when there is no time
+    // limit either the search stops at MCTS_DEFAULT_PLAYOUTS
+    void setPlayoutLimit(uint64_t limit);
+
+    // threads of the search and how they share the work,
+    // MCTS_TREE_PARALLEL or MCTS_ROOT_PARALLEL
+    void setThreadCount(int threads);
+    int getThreadCount();
+    void setParallelism(int mode);
+    int getParallelism();
+};
+
+#endif // MCTS_H
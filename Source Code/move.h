@@ -0,0 +1,29 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+
+/* Upper bound on the number of moves in any position: a move always joins a
+ * token to an empty neighbour, and the 9x5 board only has 140 pairs of
+ * adjacent tiles (40 horizontal, 36 vertical, 64 diagonal). */
+const int MAX_MOVES = 140;
+
+/* One token stepping from a square to an adjacent empty square, with the
+ * attack it triggers already resolved by the move generator. */
+struct Move {
+    uint64_t captured;      // opponent tokens removed by the move
+    int8_t from;
+    int8_t to;
+    int8_t direction;
+    int8_t captureCount;
+};
+
+/* What a search returns when the side to move has no move left, the game
+ * is over and there is nothing to play. */
+const Move NULL_MOVE = {0, -1, -1, -1, 0};
+
+inline bool isNullMove(const Move& move) {
+    return move.from < 0;
+}
+
+#endif // MOVE_H
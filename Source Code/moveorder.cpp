@@ -0,0 +1,162 @@
+#include "moveorder.h"
+
+#include <cstring>
+
+MoveOrderer::MoveOrderer() : perturbation(0)
+{
+    clear();
+}
+
+static bool sameMove(const Move& a, const Move& b) {
+    return a.from == b.from && a.to == b.to;
+}
+
+void MoveOrderer::clear() {
+    std::memset(history, 0, sizeof(history));
+    newSearch();
+    resetCounters();
+}
+
+/**
+ * @brief MoveOrderer::newSearch, forgets the killers of the last search and halves
+ *        the history so recent cutoffs weigh more than old ones
+ */
+
+void MoveOrderer::newSearch() {
+    for (int ply = 0; ply < MAX_PLY; ++ply) {
+        killers[ply][0] = {0, -1, -1, -1, 0};
+        killers[ply][1] = {0, -1, -1, -1, 0};
+    }
+
+    for (int from = 0; from < BOARD_SQUARES; ++from)
+        for (int to = 0; to < BOARD_SQUARES; ++to)
+            history[from][to] /= 2;
+}
+
+/**
+ * @brief MoveOrderer::setPerturbation, makes the helper threads of a parallel search
+ *        order quiet moves with equal history differently, so they do not all walk
+ *        the same tree, 0 keeps the plain order
+ */
+
+void MoveOrderer::setPerturbation(int seed) {
+    perturbation = seed;
+}
+
+/**
+ * @brief MoveOrderer::scoreMoves, gives each move its ordering score
+ * @param moves, the generated moves
+ * @param scores, filled with one score per move, higher is searched first
+ * @param count, number of moves
+ * @param ply, distance from the root
+ * @param hashFrom, origin of the hash move, -1 if there is none
+ * @param hashTo, destination of the hash move
+ */
+
+void MoveOrderer::scoreMoves(const Move* moves, int* scores, int count, int ply, int hashFrom, int hashTo) const {
+    for (int i = 0; i < count; ++i) {
+        const Move& move = moves[i];
+
+        if (move.from == hashFrom && move.to == hashTo)
+            scores[i] = ORDER_HASH_MOVE;
+        else if (move.captureCount > 0)
+            scores[i] = ORDER_CAPTURE + move.captureCount;
+        else if (sameMove(move, killers[ply][0]))
+            scores[i] = ORDER_KILLER + 1;
+        else if (sameMove(move, killers[ply][1]))
+            scores[i] = ORDER_KILLER;
+        else if (perturbation != 0)
+            scores[i] = history[move.from][move.to] + ((move.from * 7 + move.to * 13 + perturbation * 29) & 15);
+        else
+            scores[i] = history[move.from][move.to];
+    }
+}
+
+/**
+ * @brief MoveOrderer::scoreRootMoves, gives each root move its ordering score, the
+ *        helpers of a parallel search still start from different moves
+ * @param bestFrom, origin of the best move of the last iteration, -1 if there is none
+ * @param bestTo, destination of the best move of the last iteration
+ */
+
+void MoveOrderer::scoreRootMoves(const Move* moves, int* scores, int count, int bestFrom, int bestTo) const {
+    for (int i = 0; i < count; ++i) {
+        const Move& move = moves[i];
+
+        if (move.from == bestFrom && move.to == bestTo)
+            scores[i] = ORDER_HASH_MOVE;
+        else if (move.captureCount > 0)
+            scores[i] = ORDER_CAPTURE + move.captureCount;
+        else if (perturbation != 0)
+            scores[i] = (move.from * 7 + move.to * 13 + perturbation * 29) & 15;
+        else
+            scores[i] = 0;
+    }
+}
+
+/**
+ * @brief MoveOrderer::pickMove, brings the best scored move of index..count-1 to index,
+ *        picking one move at a time costs nothing for the moves a cutoff never reaches
+ */
+
+void MoveOrderer::pickMove(Move* moves, int* scores, int index, int count) const {
+    int best = index;
+
+    for (int i = index + 1; i < count; ++i) {
+        if (scores[i] > scores[best])
+            best = i;
+    }
+
+    if (best != index) {
+        Move move = moves[index];
+        moves[index] = moves[best];
+        moves[best] = move;
+
+        int score = scores[index];
+        scores[index] = scores[best];
+        scores[best] = score;
+    }
+}
+
+/**
+ * @brief MoveOrderer::addCutoff, learns from a move that failed high
+ * @param move, the move that caused the cutoff
+ * @param ply, distance from the root
+ * @param remaining, plies left below the node, deeper cutoffs count more
+ * @param moveNumber, position of the move in the search order, 0 = first
+ */
+
+void MoveOrderer::addCutoff(const Move& move, int ply, int remaining, int moveNumber) {
+    cutoffs++;
+
+    if (moveNumber == 0)
+        firstMoveCutoffs++;
+
+    cutoffsAtMove[moveNumber < CUTOFF_SLOTS ? moveNumber : CUTOFF_SLOTS - 1]++;
+
+    // captures are already searched early, only quiet moves are remembered
+    if (move.captureCount > 0)
+        return;
+
+    if (!sameMove(move, killers[ply][0])) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    int& value = history[move.from][move.to];
+    value += remaining * remaining;
+
+    if (value >= HISTORY_MAX) {
+        for (int from = 0; from < BOARD_SQUARES; ++from)
+            for (int to = 0; to < BOARD_SQUARES; ++to)
+                history[from][to] /= 2;
+    }
+}
+
+void MoveOrderer::resetCounters() {
+    cutoffs = 0;
+    firstMoveCutoffs = 0;
+
+    for (int i = 0; i < CUTOFF_SLOTS; ++i)
+        cutoffsAtMove[i] = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef MOVEORDER_H
+#define MOVEORDER_H
+
+#include <cstdint>
+
+#include "position.h"
+
+/* Move ordering for alpha-beta, best candidates first:
+ *  1. the hash (principal variation) move from the transposition table
+ *  2. captures, the more tokens removed the earlier
+ *  3. the two killer moves of the ply, quiet moves that caused a cutoff in a sibling
+ *  4. the remaining quiet moves by their history score
+ * The root moves are scored without killers and history, the best move of
+ * the last iteration first, captures next and the rest in generated order,
+ * so the move played among equally scored ones does not depend on what the
+ * search happened to visit before. */
+
+const int ORDER_HASH_MOVE = 1 << 30;
+const int ORDER_CAPTURE = 1 << 28;
+const int ORDER_KILLER = 1 << 27;
+const int HISTORY_MAX = 1 << 26;
+
+// Positions in the search order the cutoffs are counted for,
+// the last one counts the cutoffs of every later move
+const int CUTOFF_SLOTS = 8;
+
+class MoveOrderer
+{
+private:
+    Move killers[MAX_PLY][2];
+    int history[BOARD_SQUARES][BOARD_SQUARES];
+
+    int perturbation;
+
+    uint64_t cutoffs;
+    uint64_t firstMoveCutoffs;
+    uint64_t cutoffsAtMove[CUTOFF_SLOTS];
+
+public:
+    MoveOrderer();
+
+    void clear();
+    void newSearch();
+    void setPerturbation(int seed);
+
+    void scoreMoves(const Move* moves, int* scores, int count, int ply, int hashFrom, int hashTo) const;
+    void scoreRootMoves(const Move* moves, int* scores, int count, int bestFrom, int bestTo) const;
+    void pickMove(Move* moves, int* scores, int index, int count) const;
+    void addCutoff(const Move& move, int ply, int remaining, int moveNumber);
+
+    uint64_t getCutoffs() const { return cutoffs; }
+    uint64_t getFirstMoveCutoffs() const { return firstMoveCutoffs; }
+    uint64_t getCutoffsAtMove(int slot) const { return cutoffsAtMove[slot]; }
+    void resetCounters();
+};
+
+#endif // MOVEORDER_H
@@ -0,0 +1,155 @@
+#ifndef MOVETABLES_H
+#define MOVETABLES_H
+
+#include <cstdint>
+
+#include "position.h"
+
+/* Directions in the order Board::getEmptyAdjacentValidTiles has always
+ * listed them, so table driven move generation keeps the same move order.
+ * The opposite of direction d is (d + 4) % 8. */
+
+enum Direction {
+    NORTH,
+    NORTH_EAST,
+    EAST,
+    SOUTH_EAST,
+    SOUTH,
+    SOUTH_WEST,
+    WEST,
+    NORTH_WEST,
+    DIRECTION_COUNT
+};
+
+constexpr int DIRECTION_X[DIRECTION_COUNT] = {0, 1, 1, 1, 0, -1, -1, -1};
+constexpr int DIRECTION_Y[DIRECTION_COUNT] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+constexpr int oppositeDirection(int direction) {
+    return (direction + 4) % DIRECTION_COUNT;
+}
+
+constexpr bool isDiagonal(int direction) {
+    return direction % 2 == 1;
+}
+
+// Square index grows along NORTH_EAST, EAST, SOUTH_EAST and SOUTH, shrinks along the others
+constexpr bool isAscending(int direction) {
+    return direction >= NORTH_EAST && direction <= SOUTH;
+}
+
+// Direction of a one tile step (dx, dy), or -1 if it is not a step
+constexpr int getDirection(int dx, int dy) {
+    return dx == 0 && dy == -1 ? NORTH
+         : dx == 1 && dy == -1 ? NORTH_EAST
+         : dx == 1 && dy == 0 ? EAST
+         : dx == 1 && dy == 1 ? SOUTH_EAST
+         : dx == 0 && dy == 1 ? SOUTH
+         : dx == -1 && dy == 1 ? SOUTH_WEST
+         : dx == -1 && dy == 0 ? WEST
+         : dx == -1 && dy == -1 ? NORTH_WEST
+         : -1;
+}
+
+/**
+ * Per square lookup tables, built at compile time.
+ *  step[sq][d]    : target of a one tile move in direction d, -1 if off the board
+ *                   or if d is diagonal and sq is a white tile
+ *  stepMask[sq]   : every legal step target of sq
+ *  rayMask[sq][d] : every tile beyond sq in direction d up to the edge, this is
+ *                   the line a capture walks along
+ */
+struct MoveTables {
+    int8_t step[BOARD_SQUARES][DIRECTION_COUNT];
+    uint64_t stepMask[BOARD_SQUARES];
+    uint64_t rayMask[BOARD_SQUARES][DIRECTION_COUNT];
+
+    constexpr MoveTables() : step(), stepMask(), rayMask() {
+        for (int square = 0; square < BOARD_SQUARES; ++square) {
+            int x = square / BOARD_HEIGHT;
+            int y = square % BOARD_HEIGHT;
+            bool whiteTile = (x + y) % 2 == 1;
+
+            for (int d = 0; d < DIRECTION_COUNT; ++d) {
+                int nx = x + DIRECTION_X[d];
+                int ny = y + DIRECTION_Y[d];
+                bool onBoard = nx >= 0 && nx < BOARD_WIDTH && ny >= 0 && ny < BOARD_HEIGHT;
+
+                step[square][d] = -1;
+
+                if (onBoard && !(whiteTile && isDiagonal(d))) {
+                    step[square][d] = static_cast<int8_t>(nx * BOARD_HEIGHT + ny);
+                    stepMask[square] |= 1ULL << (nx * BOARD_HEIGHT + ny);
+                }
+
+                while (nx >= 0 && nx < BOARD_WIDTH && ny >= 0 && ny < BOARD_HEIGHT) {
+                    rayMask[square][d] |= 1ULL << (nx * BOARD_HEIGHT + ny);
+                    nx += DIRECTION_X[d];
+                    ny += DIRECTION_Y[d];
+                }
+            }
+        }
+    }
+};
+
+constexpr MoveTables MOVE_TABLES{};
+
+/**
+ * @brief captureRay, returns the run of opponent tokens directly after square in
+ *        the given direction, stopping at the first empty tile, own token or edge
+ * @param square, the tile the run starts next to
+ * @param direction, the direction to walk
+ * @param opponent, mask of the opponent tokens
+ * @return mask of the tokens the run covers, 0 if the adjacent tile is not an opponent
+ */
+inline uint64_t captureRay(int square, int direction, uint64_t opponent) {
+    uint64_t ray = MOVE_TABLES.rayMask[square][direction];
+    uint64_t blockers = ray & ~opponent;
+
+    if (blockers == 0)
+        return ray;
+
+    if (isAscending(direction)) {
+        // the closest blocker is the lowest bit, keep everything below it
+        uint64_t closest = blockers & (0 - blockers);
+        return ray & (closest - 1);
+    }
+
+    // the closest blocker is the highest bit, keep everything above it
+    uint64_t closest = squareBit(lastSquare(blockers));
+    return ray & ~((closest << 1) - 1);
+}
+
+/**
+ * @brief getCaptures, resolves the attack of a token moving from -> to
+ *        the forward run is taken first, the backward run only if the forward one is empty
+ * @return mask of the captured tokens
+ */
+inline uint64_t getCaptures(int from, int to, int direction, uint64_t opponent) {
+    uint64_t captured = captureRay(to, direction, opponent);
+
+    if (captured == 0)
+        captured = captureRay(from, oppositeDirection(direction), opponent);
+
+    return captured;
+}
+
+/**
+ * @brief tokenStreak, longest run of tokens directly next to square in any of the
+ *        eight directions, whatever the colour of the tile
+ * @param square, the tile the runs start next to
+ * @param tokens, mask of the tokens counted
+ */
+inline int tokenStreak(int square, uint64_t tokens) {
+    int streak = 0;
+
+    for (int d = 0; d < DIRECTION_COUNT; ++d) {
+        int run = popCount(captureRay(square, d, tokens));
+
+        if (run > streak)
+            streak = run;
+    }
+
+    return streak;
+}
+
+#endif // MOVETABLES_H
@@ -0,0 +1,131 @@
+#include "notation.h"
+
+std::string squareName(int square) {
+    std::string name(1, char('A' + Position::getY(square)));
+
+    return name + std::to_string(Position::getX(square) + 1);
+}
+
+/**
+ * @brief parseSquare, reads a square name, lower case row letters are accepted
+ * @return the square, -1 if name is not a square of the board
+ */
+
+int parseSquare(const std::string& name) {
+    if (name.size() != 2)
+        return -1;
+
+    int y = (name[0] | 0x20) - 'a';
+    int x = name[1] - '1';
+
+    if (y < 0 || y >= BOARD_HEIGHT || x < 0 || x >= BOARD_WIDTH)
+        return -1;
+
+    return Position::getSquare(x, y);
+}
+
+std::string moveName(const Move& move) {
+    if (isNullMove(move))
+        return "none";
+
+    return squareName(move.from) + squareName(move.to);
+}
+
+/**
+ * @brief lineName, names the moves of a line of play, separated by spaces
+ */
+
+std::string lineName(const std::vector<Move>& moves) {
+    std::string name;
+
+    for (const Move& move : moves)
+        name += (name.empty() ? "" : " ") + moveName(move);
+
+    return name;
+}
+
+/**
+ * @brief parseMove, reads a move and checks it against the legal moves of the position
+ * @param position, the position the move is played on
+ * @param name, the move, origin then destination square
+ * @param move, set to the move with its captures when it is legal
+ * @return whether name is a legal move of either side
+ */
+
+bool parseMove(const Position& position, const std::string& name, Move& move) {
+    if (name.size() != 4)
+        return false;
+
+    int from = parseSquare(name.substr(0, 2));
+    int to = parseSquare(name.substr(2, 2));
+
+    if (from < 0 || to < 0)
+        return false;
+
+    char player = position.getValueAt(Position::getX(from), Position::getY(from));
+
+    if (player == 'X')
+        return false;
+
+    Move moves[MAX_MOVES];
+    int moveCount = position.generateMoves(player, moves);
+
+    for (int i = 0; i < moveCount; i++) {
+        if (moves[i].from == from && moves[i].to == to) {
+            move = moves[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::string positionName(const Position& position) {
+    std::string name;
+
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        if (y > 0)
+            name += '/';
+
+        for (int x = 0; x < BOARD_WIDTH; x++)
+            name += position.getValueAt(x, y);
+    }
+
+    return name;
+}
+
+/**
+ * @brief parsePosition, reads a position, "start" names the starting position
+ * @param name, the rows of the board
+ * @param position, set to the position when name is valid
+ * @return whether name is a position
+ */
+
+bool parsePosition(const std::string& name, Position& position) {
+    if (name == "start") {
+        position = Position();
+        return true;
+    }
+
+    if (name.size() != BOARD_HEIGHT * (BOARD_WIDTH + 1) - 1)
+        return false;
+
+    Position parsed(0, 0);
+
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            char value = name[y * (BOARD_WIDTH + 1) + x] & ~0x20;
+
+            if (value != 'R' && value != 'G' && value != 'X')
+                return false;
+
+            parsed.setValueAt(x, y, value);
+        }
+
+        if (y + 1 < BOARD_HEIGHT && name[y * (BOARD_WIDTH + 1) + BOARD_WIDTH] != '/')
+            return false;
+    }
+
+    position = parsed;
+    return true;
+}
@@ -0,0 +1,25 @@
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include <string>
+#include <vector>
+
+#include "position.h"
+
+/* Text form of squares, moves and positions for the command-line engine.
+ * A square is named like its board button, row letter then column number
+ * ("C5"), a move by its two squares ("C5B5"), and a position by its rows A
+ * to E separated by '/', one R, G or X per tile:
+ *   RRRRRRRRR/RRRRRRRRR/GGGGXRRRR/GGGGGGGGG/GGGGGGGGG */
+
+std::string squareName(int square);
+int parseSquare(const std::string& name);
+
+std::string moveName(const Move& move);
+std::string lineName(const std::vector<Move>& moves);
+bool parseMove(const Position& position, const std::string& name, Move& move);
+
+std::string positionName(const Position& position);
+bool parsePosition(const std::string& name, Position& position);
+
+#endif // NOTATION_H
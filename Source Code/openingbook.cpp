@@ -0,0 +1,150 @@
+#include "openingbook.h"
+#include "zobrist.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+uint64_t openingBookKey(const Position& position, char player) {
+    return position.getHash() ^ (player == 'R' ? ZOBRIST_KEYS.redToMove : 0);
+}
+
+/**
+ * @brief writeOpeningBook, writes a book in the order it is probed in
+ * @param path, the book file
+ * @param header, the plies, depth and heuristic of the book, the rest is filled in
+ * @param entries, the moves of every position, sorted by key and weight on return
+ */
+
+bool writeOpeningBook(const std::string& path, OpeningBookHeader header, std::vector<OpeningBookEntry>& entries) {
+    std::sort(entries.begin(), entries.end(), [](const OpeningBookEntry& a, const OpeningBookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    memcpy(header.magic, "BZBK", 4);
+    header.version = OPENING_BOOK_VERSION;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+
+    FILE* file = fopen(path.c_str(), "wb");
+
+    if (!file)
+        return false;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+                && fwrite(entries.data(), sizeof(OpeningBookEntry), entries.size(), file) == entries.size();
+
+    return fclose(file) == 0 && written;
+}
+
+OpeningBook::OpeningBook() : header(nullptr), entries(nullptr)
+{
+}
+
+/**
+ * @brief OpeningBook::load, maps a book written by bookgen
+ * @param path, the book file
+ * @return whether the book can be probed
+ */
+
+bool OpeningBook::load(const std::string& path) {
+    unload();
+
+    if (!file.open(path))
+        return false;
+
+    const OpeningBookHeader* mapped = reinterpret_cast<const OpeningBookHeader*>(file.getData());
+    size_t size = file.getSize();
+
+    bool valid = size >= sizeof(OpeningBookHeader) && memcmp(mapped->magic, "BZBK", 4) == 0
+            && mapped->version == OPENING_BOOK_VERSION
+            && (size - sizeof(OpeningBookHeader)) / sizeof(OpeningBookEntry) >= mapped->entryCount;
+
+    if (!valid) {
+        file.close();
+        return false;
+    }
+
+    header = mapped;
+    entries = reinterpret_cast<const OpeningBookEntry*>(file.getData() + sizeof(OpeningBookHeader));
+    return true;
+}
+
+void OpeningBook::unload() {
+    file.close();
+    header = nullptr;
+    entries = nullptr;
+}
+
+bool OpeningBook::isLoaded() const {
+    return header != nullptr;
+}
+
+const OpeningBookHeader* OpeningBook::getHeader() const {
+    return header;
+}
+
+int OpeningBook::getEntries(const Position& position, char player, const OpeningBookEntry*& first) const {
+    if (!header)
+        return 0;
+
+    uint64_t key = openingBookKey(position, player);
+    const OpeningBookEntry* end = entries + header->entryCount;
+
+    first = std::lower_bound(entries, end, key, [](const OpeningBookEntry& entry, uint64_t value) {
+        return entry.key < value;
+    });
+
+    const OpeningBookEntry* last = first;
+
+    while (last != end && last->key == key)
+        last++;
+
+    return static_cast<int>(last - first);
+}
+
+/**
+ * @brief OpeningBook::probe, picks a move of the book for the position, the moves the
+ *        position does not have are left out
+ * @param random, chooses between the moves, the same number picks the same move
+ */
+
+bool OpeningBook::probe(const Position& position, char player, uint64_t random, Move& move, OpeningBookEntry& entry) const {
+    const OpeningBookEntry* first = nullptr;
+    int count = getEntries(position, player, first);
+
+    if (count == 0)
+        return false;
+
+    Move moves[MAX_MOVES];
+    int moveCount = position.generateMoves(player, moves);
+    Move legal[MAX_MOVES];
+    int legalEntries[MAX_MOVES];
+    int legalCount = 0;
+    uint64_t totalWeight = 0;
+
+    for (int i = 0; i < count && legalCount < MAX_MOVES; i++) {
+        for (int j = 0; j < moveCount; j++) {
+            if (moves[j].from == first[i].from && moves[j].to == first[i].to && first[i].weight > 0) {
+                legal[legalCount] = moves[j];
+                legalEntries[legalCount++] = i;
+                totalWeight += first[i].weight;
+                break;
+            }
+        }
+    }
+
+    if (legalCount == 0)
+        return false;
+
+    uint64_t pick = random % totalWeight;
+    int chosen = 0;
+
+    while (pick >= first[legalEntries[chosen]].weight) {
+        pick -= first[legalEntries[chosen]].weight;
+        chosen++;
+    }
+
+    move = legal[chosen];
+    entry = first[legalEntries[chosen]];
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mappedfile.h"
+#include "position.h"
+
+/* Opening book, moves for the positions the first plies of a game reach
+ * from the start, searched ahead of time far deeper than a game can afford
+ * (tools/bookgen). A position is found by its key, the Zobrist hash of its
+ * tokens and the side to move, so the move orders that lead to the same
+ * position share its moves.
+ *
+ * A book is a file: the header, then one entry per move, sorted by key and
+ * the moves of a key heaviest first, so a probe is a binary search of the
+ * mapped file. The weight of a move is how much the search backs it, the
+ * best move of a position weighs the most and the others less the more
+ * they score below it; the engine picks a move at random in proportion to
+ * the weights. The picks of a player repeat from OPENING_BOOK_SEED unless
+ * it is seeded otherwise, as the game does for every new player so its
+ * games do not all follow one line. A move is checked
+ * against the moves of the position before it is played, a key that is
+ * not the position's own cannot make the engine play an illegal move. */
+
+const uint32_t OPENING_BOOK_VERSION = 1;
+// Random state a player picks the moves of the book from until seeded
+const uint64_t OPENING_BOOK_SEED = 0x426F6F6BULL;
+
+struct OpeningBookHeader {
+    char magic[4];          // "BZBK"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t plies;         // plies from the start the book covers
+    uint32_t depth;         // plies of the search behind each move
+    uint32_t heuristicIndex;
+};
+
+struct OpeningBookEntry {
+    uint64_t key;
+    int32_t score;          // of the search after the move, green minus red
+    uint16_t weight;
+    uint8_t from;
+    uint8_t to;
+};
+
+// the key of a position in the book, player is the side to move
+uint64_t openingBookKey(const Position& position, char player);
+
+// sorts the entries and writes them with the header, false when
+// the file cannot be written; the header's entry count is set here
+bool writeOpeningBook(const std::string& path, OpeningBookHeader header, std::vector<OpeningBookEntry>& entries);
+
+class OpeningBook
+{
+private:
+    MappedFile file;
+    const OpeningBookHeader* header;
+    const OpeningBookEntry* entries;
+
+public:
+    OpeningBook();
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    // maps a book, the one loaded before is closed; false when the
+    // file is missing or is not a book
+    bool load(const std::string& path);
+    void unload();
+    bool isLoaded() const;
+    const OpeningBookHeader* getHeader() const;
+
+    // the entries of the position with player to move, heaviest first,
+    // first points at the first of them; 0 when the book does not hold it
+    int getEntries(const Position& position, char player, const OpeningBookEntry*& first) const;
+
+    // a move of the book for the position, picked in proportion to the
+    // weights by random, any number; false when the book holds no legal
+    // move of player for it
+    bool probe(const Position& position, char player, uint64_t random, Move& move, OpeningBookEntry& entry) const;
+};
+
+#endif // OPENINGBOOK_H
@@ -0,0 +1,107 @@
+#include "perft.h"
+
+#include <atomic>
+#include <thread>
+
+static bool isGameOver(const Position& position) {
+    return position.getTokenAmount('R') == 0 || position.getTokenAmount('G') == 0;
+}
+
+/**
+ * @brief perft, counts the leaves of the move tree depth plies below position
+ * @param position, played on with makeMove and left as it was
+ * @param player, side to move
+ * @param depth, plies to count, 0 counts the position itself
+ */
+
+uint64_t perft(Position& position, char player, int depth) {
+    if (depth == 0)
+        return 1;
+
+    if (isGameOver(position))
+        return 0;
+
+    Move moves[MAX_MOVES];
+    int moveCount = position.generateMoves(player, moves);
+
+    // the moves of the last ply are leaves, no need to play them
+    if (depth == 1)
+        return moveCount;
+
+    char opponent = player == 'R' ? 'G' : 'R';
+    uint64_t nodes = 0;
+
+    for (int i = 0; i < moveCount; ++i) {
+        position.makeMove(moves[i]);
+        nodes += perft(position, opponent, depth - 1);
+        position.unmakeMove();
+    }
+
+    return nodes;
+}
+
+/**
+ * @brief checkIncremental, compares the incrementally kept state of every position
+ *        up to depth plies below position with the same state built from scratch
+ */
+
+uint64_t checkIncremental(Position& position, char player, int depth, uint64_t& checked) {
+    uint64_t mismatches = position.getHash() != position.computeHash()
+            || position.getPlacementScore() != position.computePlacementScore()
+            || position.getTileScore() != position.computeTileScore();
+    checked++;
+
+    if (depth == 0 || isGameOver(position))
+        return mismatches;
+
+    Move moves[MAX_MOVES];
+    int moveCount = position.generateMoves(player, moves);
+    char opponent = player == 'R' ? 'G' : 'R';
+
+    for (int i = 0; i < moveCount; ++i) {
+        position.makeMove(moves[i]);
+        mismatches += checkIncremental(position, opponent, depth - 1, checked);
+        position.unmakeMove();
+    }
+
+    return mismatches;
+}
+
+/**
+ * @brief perftDivide, counts the leaves below every root move, the threads take
+ *        the next root move from a shared counter
+ * @param depth, plies to count including the root move, at least 1
+ * @param threads, number of threads, 1 counts on the calling thread
+ * @return one entry per root move in the order of the move generator
+ */
+
+std::vector<PerftDivide> perftDivide(const Position& position, char player, int depth, int threads) {
+    Move moves[MAX_MOVES];
+    int moveCount = isGameOver(position) ? 0 : position.generateMoves(player, moves);
+    char opponent = player == 'R' ? 'G' : 'R';
+
+    std::vector<PerftDivide> divide(moveCount);
+    std::atomic<int> nextMove(0);
+
+    auto count = [&]() {
+        Position start(position.getTokens('R'), position.getTokens('G'));
+
+        for (int i = nextMove++; i < moveCount; i = nextMove++) {
+            start.makeMove(moves[i]);
+            divide[i] = {moves[i], perft(start, opponent, depth - 1)};
+            start.unmakeMove();
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (int t = 1; t < threads && t < moveCount; ++t)
+        workers.emplace_back(count);
+
+    count();
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    return divide;
+}
@@ -0,0 +1,31 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "position.h"
+
+/* Perft, the number of move sequences of a given length from a position,
+ * counted with the search's own move generator. The counts of known
+ * positions are fixed, so they check the rules code after any change and
+ * time its raw speed. A position where a side has no token left is over
+ * and ends its lines early; the stalemate rule is left out since it does
+ * not depend on the position alone. */
+
+struct PerftDivide {
+    Move move;
+    uint64_t nodes; //Leaves below the root move
+};
+
+uint64_t perft(Position& position, char player, int depth);
+
+// walks the same tree and compares what Position keeps up to date move by
+// move, the hash and evaluation sums, with the values built from scratch;
+// returns the number of positions that differ, counts every position in checked
+uint64_t checkIncremental(Position& position, char player, int depth, uint64_t& checked);
+
+// leaves below each root move, the root moves are split between threads
+std::vector<PerftDivide> perftDivide(const Position& position, char player, int depth, int threads);
+
+#endif // PERFT_H
@@ -0,0 +1,263 @@
+#include "position.h"
+#include "movetables.h"
+#include "zobrist.h"
+
+/**
+ * @brief Position::Position, builds the starting position
+ *        rows 0-1 red, rows 3-4 green, row 2 split with the middle tile empty
+ */
+
+Position::Position() : redTokens(0), greenTokens(0), hash(0), undoCount(0)
+{
+    for (int x = 0; x < BOARD_WIDTH; ++x) {
+        for (int y = 0; y < BOARD_HEIGHT; ++y) {
+            if (y <= 1 || (y == 2 && x >= 5))
+                redTokens |= squareBit(getSquare(x, y));
+            else if (y >= 3 || (y == 2 && x <= 3))
+                greenTokens |= squareBit(getSquare(x, y));
+        }
+    }
+
+    hash = computeHash();
+    placementScore = computePlacementScore();
+    tileScore = computeTileScore();
+}
+
+Position::Position(uint64_t red, uint64_t green) : redTokens(red & BOARD_MASK), greenTokens(green & BOARD_MASK), undoCount(0)
+{
+    hash = computeHash();
+    placementScore = computePlacementScore();
+    tileScore = computeTileScore();
+}
+
+/**
+ * @brief Position::getValueAt, returns the token at x, y coordinates
+ * @return char, 'R' = red, 'G' = green, 'X' = empty
+ */
+
+char Position::getValueAt(int x, int y) const {
+    uint64_t bit = squareBit(getSquare(x, y));
+
+    if (redTokens & bit)
+        return 'R';
+    if (greenTokens & bit)
+        return 'G';
+
+    return 'X';
+}
+
+void Position::setValueAt(int x, int y, char value) {
+    uint64_t bit = squareBit(getSquare(x, y));
+
+    redTokens &= ~bit;
+    greenTokens &= ~bit;
+
+    if (value == 'R')
+        redTokens |= bit;
+    else if (value == 'G')
+        greenTokens |= bit;
+
+    hash = computeHash();
+    placementScore = computePlacementScore();
+    tileScore = computeTileScore();
+}
+
+/**
+ * @brief Position::computeHash, Zobrist key of the tokens on the board, built from scratch
+ *        (makeMove and unmakeMove keep hash up to date incrementally)
+ */
+
+uint64_t Position::computeHash() const {
+    uint64_t key = 0;
+
+    for (int square = 0; square < BOARD_SQUARES; ++square) {
+        if (redTokens & squareBit(square))
+            key ^= tokenKey('R', square);
+        else if (greenTokens & squareBit(square))
+            key ^= tokenKey('G', square);
+    }
+
+    return key;
+}
+
+/**
+ * @brief Position::updateHash, toggles the keys a move changes, applying it twice restores the key
+ * @param move, the move
+ * @param player, the side that plays it
+ */
+
+void Position::updateHash(const Move& move, char player) {
+    char opponent = player == 'R' ? 'G' : 'R';
+    uint64_t captured = move.captured;
+
+    hash ^= tokenKey(player, move.from) ^ tokenKey(player, move.to);
+
+    while (captured) {
+        hash ^= tokenKey(opponent, firstSquare(captured));
+        captured &= captured - 1;
+    }
+}
+
+/**
+ * @brief Position::computePlacementScore, naive heuristic value of the tokens built from scratch,
+ *        every column and row weighted by its 1-based index (makeMove and unmakeMove keep
+ *        placementScore up to date incrementally)
+ */
+
+int Position::computePlacementScore() const {
+    int h_green_sum=0, h_red_sum=0, v_green_sum=0, v_red_sum=0;
+
+    for (int i = 0; i < BOARD_WIDTH; i++){
+        h_green_sum += (i+1) * popCount(greenTokens & columnMask(i));
+        h_red_sum += (i+1) * popCount(redTokens & columnMask(i));
+    }
+
+    for (int j = 0; j < BOARD_HEIGHT; j++){
+        v_green_sum += (j+1) * popCount(greenTokens & rowMask(j));
+        v_red_sum += (j+1) * popCount(redTokens & rowMask(j));
+    }
+
+    return 100*v_green_sum+50*h_green_sum-100*v_red_sum-50*h_red_sum;
+}
+
+/**
+ * @brief Position::computeTileScore, material of the informed heuristic built from scratch,
+ *        tokens on white tiles are worth 100, on black tiles 50
+ */
+
+int Position::computeTileScore() const {
+    int greenCtr = 100 * popCount(greenTokens & WHITE_TILES) + 50 * popCount(greenTokens & BLACK_TILES);
+    int redCtr = 100 * popCount(redTokens & WHITE_TILES) + 50 * popCount(redTokens & BLACK_TILES);
+
+    return greenCtr - redCtr;
+}
+
+/**
+ * @brief Position::updateScores, adds the change a move makes to the evaluation sums
+ * @param move, the move
+ * @param player, the side that plays it
+ * @param sign, 1 to play the move, -1 to take it back
+ */
+
+void Position::updateScores(const Move& move, char player, int sign) {
+    // green adds its weights and red subtracts them, so removing a red token adds its weight
+    int side = player == 'G' ? sign : -sign;
+    int placement = placementWeight(move.to) - placementWeight(move.from);
+    int tile = tileWeight(move.to) - tileWeight(move.from);
+    uint64_t captured = move.captured;
+
+    while (captured) {
+        int square = firstSquare(captured);
+        placement += placementWeight(square);
+        tile += tileWeight(square);
+        captured &= captured - 1;
+    }
+
+    placementScore += side * placement;
+    tileScore += side * tile;
+}
+
+/**
+ * @brief Position::getMove, builds the move of the token on from to the adjacent tile to,
+ *        the move must be legal (see Board::checkMove)
+ * @param from, origin square
+ * @param to, destination square
+ * @return the move, captures included
+ */
+
+Move Position::getMove(int from, int to) const {
+    int direction = getDirection(getX(to) - getX(from), getY(to) - getY(from));
+    uint64_t opponent = (redTokens & squareBit(from)) ? greenTokens : redTokens;
+    uint64_t captured = direction >= 0 ? getCaptures(from, to, direction, opponent) : 0;
+
+    return {captured, static_cast<int8_t>(from), static_cast<int8_t>(to), static_cast<int8_t>(direction), static_cast<int8_t>(popCount(captured))};
+}
+
+/**
+ * @brief Position::generateMoves, lists every legal move of player with its captures,
+ *        token by token column by column, and for each token in the direction order of the step table
+ * @param player, 'R' or 'G'
+ * @param moves, buffer of at least MAX_MOVES entries
+ * @return the number of moves written
+ */
+
+int Position::generateMoves(char player, Move* moves) const {
+    uint64_t tokens = getTokens(player);
+    uint64_t opponent = getTokens(player == 'R' ? 'G' : 'R');
+    uint64_t emptyTiles = getEmptyTiles();
+    int moveCount = 0;
+
+    while (tokens) {
+        int from = firstSquare(tokens);
+        tokens &= tokens - 1;
+
+        if ((MOVE_TABLES.stepMask[from] & emptyTiles) == 0)
+            continue;
+
+        for (int d = 0; d < DIRECTION_COUNT; ++d) {
+            int to = MOVE_TABLES.step[from][d];
+
+            if (to < 0 || (emptyTiles & squareBit(to)) == 0)
+                continue;
+
+            uint64_t captured = getCaptures(from, to, d, opponent);
+            moves[moveCount++] = {captured, static_cast<int8_t>(from), static_cast<int8_t>(to), static_cast<int8_t>(d), static_cast<int8_t>(popCount(captured))};
+        }
+    }
+
+    return moveCount;
+}
+
+/**
+ * @brief Position::applyMove, plays a move without recording it, used for the game board
+ */
+
+void Position::applyMove(const Move& move) {
+    uint64_t fromBit = squareBit(move.from);
+    uint64_t toBit = squareBit(move.to);
+
+    if (redTokens & fromBit) {
+        redTokens ^= fromBit | toBit;
+        greenTokens &= ~move.captured;
+        updateHash(move, 'R');
+        updateScores(move, 'R', 1);
+    }
+    else {
+        greenTokens ^= fromBit | toBit;
+        redTokens &= ~move.captured;
+        updateHash(move, 'G');
+        updateScores(move, 'G', 1);
+    }
+}
+
+/**
+ * @brief Position::makeMove, plays a move and keeps it so it can be undone
+ */
+
+void Position::makeMove(const Move& move) {
+    applyMove(move);
+    undoStack[undoCount++] = move;
+}
+
+/**
+ * @brief Position::unmakeMove, takes back the last move made with makeMove
+ */
+
+void Position::unmakeMove() {
+    const Move& move = undoStack[--undoCount];
+    uint64_t fromBit = squareBit(move.from);
+    uint64_t toBit = squareBit(move.to);
+
+    if (redTokens & toBit) {
+        redTokens ^= fromBit | toBit;
+        greenTokens |= move.captured;
+        updateHash(move, 'R');
+        updateScores(move, 'R', -1);
+    }
+    else {
+        greenTokens ^= fromBit | toBit;
+        redTokens |= move.captured;
+        updateHash(move, 'G');
+        updateScores(move, 'G', -1);
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "move.h"
+
+/* Square index of tile (x, y) is x * HEIGHT + y, so walking the bits from
+ * low to high visits the board column by column like the old matrix did. */
+
+const int BOARD_WIDTH = 9;
+const int BOARD_HEIGHT = 5;
+const int BOARD_SQUARES = BOARD_WIDTH * BOARD_HEIGHT;
+const uint64_t BOARD_MASK = (1ULL << BOARD_SQUARES) - 1;
+
+// Deepest line makeMove can stack before unmakeMove has to be called
+const int MAX_PLY = 64;
+
+// the bit intrinsics of the compiler, bits must not be 0 for firstSquare and lastSquare
+inline int popCount(uint64_t bits) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(bits));
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+inline int firstSquare(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long square;
+    _BitScanForward64(&square, bits);
+    return static_cast<int>(square);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+inline int lastSquare(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long square;
+    _BitScanReverse64(&square, bits);
+    return static_cast<int>(square);
+#else
+    return 63 - __builtin_clzll(bits);
+#endif
+}
+
+constexpr uint64_t squareBit(int square) {
+    return 1ULL << square;
+}
+
+constexpr uint64_t columnMask(int x) {
+    return ((1ULL << BOARD_HEIGHT) - 1) << (x * BOARD_HEIGHT);
+}
+
+constexpr uint64_t rowMask(int y, int x = 0) {
+    return x >= BOARD_WIDTH ? 0 : squareBit(x * BOARD_HEIGHT + y) | rowMask(y, x + 1);
+}
+
+// Tiles where x + y is odd are white (diagonal moves not allowed from them)
+constexpr uint64_t whiteTilesMask(int square = 0) {
+    return square >= BOARD_SQUARES ? 0
+         : (((square / BOARD_HEIGHT + square % BOARD_HEIGHT) % 2 == 1) ? squareBit(square) : 0) | whiteTilesMask(square + 1);
+}
+
+const uint64_t WHITE_TILES = whiteTilesMask();
+const uint64_t BLACK_TILES = BOARD_MASK & ~WHITE_TILES;
+
+// Worth of a token on a square for the naive heuristic, 100 per row and 50 per column, 1-based
+constexpr int placementWeight(int square) {
+    return 100 * (square % BOARD_HEIGHT + 1) + 50 * (square / BOARD_HEIGHT + 1);
+}
+
+// Worth of a token on a square for the informed heuristic, 100 on white tiles, 50 on black ones
+constexpr int tileWeight(int square) {
+    return (WHITE_TILES & squareBit(square)) ? 100 : 50;
+}
+
+class Position
+{
+private:
+    uint64_t redTokens;
+    uint64_t greenTokens;
+    uint64_t hash;
+    int placementScore; //Sum of the placement weights, green minus red
+    int tileScore; //Sum of the tile weights, green minus red
+    Move undoStack[MAX_PLY];
+    int undoCount;
+
+    void updateHash(const Move& move, char player);
+    void updateScores(const Move& move, char player, int sign);
+
+public:
+    Position();
+    Position(uint64_t red, uint64_t green);
+
+    static int getSquare(int x, int y) { return x * BOARD_HEIGHT + y; }
+    static int getX(int square) { return square / BOARD_HEIGHT; }
+    static int getY(int square) { return square % BOARD_HEIGHT; }
+
+    char getValueAt(int x, int y) const;
+    void setValueAt(int x, int y, char value);
+    uint64_t getTokens(char player) const { return player == 'R' ? redTokens : greenTokens; }
+    uint64_t getEmptyTiles() const { return BOARD_MASK & ~(redTokens | greenTokens); }
+    int getTokenAmount(char player) const { return popCount(getTokens(player)); }
+    uint64_t getHash() const { return hash; }
+    uint64_t computeHash() const;
+    int getPlacementScore() const { return placementScore; }
+    int getTileScore() const { return tileScore; }
+    int computePlacementScore() const;
+    int computeTileScore() const;
+
+    Move getMove(int from, int to) const;
+    int generateMoves(char player, Move* moves) const;
+    void applyMove(const Move& move);
+    void makeMove(const Move& move);
+    void unmakeMove();
+    int getUndoCount() const { return undoCount; }
+    const Move& getLastMove() const { return undoStack[undoCount - 1]; }
+
+    bool operator==(const Position& other) const { return redTokens == other.redTokens && greenTokens == other.greenTokens; }
+    bool operator!=(const Position& other) const { return !(*this == other); }
+};
+
+#endif // POSITION_H
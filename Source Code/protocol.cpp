@@ -0,0 +1,250 @@
+#include "protocol.h"
+#include "notation.h"
+
+#include <cstdlib>
+#include <sstream>
+
+EngineProtocol::EngineProtocol(std::ostream& output) : output(output), side('G'), ai(&board), mcts(&board)
+{
+    ai.setTracing(false);
+    ai.setIterationCallback([this](int depth, int score, uint64_t nodes, const Move& move) {
+        send("info depth " + std::to_string(depth) + " score " + std::to_string(score)
+             + " nodes " + std::to_string(nodes) + " time " + std::to_string(getElapsedMs())
+             + " pv " + (ai.getPrincipalVariation().empty() ? moveName(move) : lineName(ai.getPrincipalVariation())));
+    });
+}
+
+EngineProtocol::~EngineProtocol()
+{
+    ai.stopSearch();
+    mcts.stopSearch();
+    waitForSearch();
+}
+
+void EngineProtocol::send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    output << line << std::endl;
+}
+
+void EngineProtocol::waitForSearch() {
+    if (searchThread.joinable())
+        searchThread.join();
+}
+
+long long EngineProtocol::getElapsedMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart).count();
+}
+
+/**
+ * @brief EngineProtocol::handleLine, runs one command
+ * @param line, the command and its arguments
+ * @return false when the command is quit
+ */
+
+bool EngineProtocol::handleLine(const std::string& line) {
+    std::istringstream arguments(line);
+    std::string command;
+
+    if (!(arguments >> command))
+        return true;
+
+    if (command == "quit") {
+        ai.stopSearch();
+        mcts.stopSearch();
+        waitForSearch();
+        return false;
+    }
+    else if (command == "stop") {
+        ai.stopSearch();
+        mcts.stopSearch();
+    }
+    else if (command == "isready")
+        send("readyok");
+    else if (command == "position")
+        setPosition(arguments);
+    else if (command == "setoption")
+        setOption(arguments);
+    else if (command == "go")
+        go(arguments);
+    else
+        send("error unknown command " + command);
+
+    return true;
+}
+
+void EngineProtocol::setPosition(std::istream& arguments) {
+    std::string name, sideName, word;
+    Position parsed;
+
+    if (!(arguments >> name >> sideName) || !parsePosition(name, parsed)
+            || (sideName != "R" && sideName != "G")) {
+        send("error invalid position");
+        return;
+    }
+
+    char parsedSide = sideName[0];
+
+    if (arguments >> word) {
+        if (word != "moves") {
+            send("error expected moves, got " + word);
+            return;
+        }
+
+        while (arguments >> word) {
+            Move move;
+
+            if (!parseMove(parsed, word, move) || parsed.getValueAt(Position::getX(move.from), Position::getY(move.from)) != parsedSide) {
+                send("error illegal move " + word);
+                return;
+            }
+
+            parsed.applyMove(move);
+            parsedSide = parsedSide == 'G' ? 'R' : 'G';
+        }
+    }
+
+    waitForSearch();
+    position = Position(parsed.getTokens('R'), parsed.getTokens('G'));
+    side = parsedSide;
+}
+
+void EngineProtocol::setOption(std::istream& arguments) {
+    std::string name;
+    int value;
+
+    // the options that take a path, an empty one turns the tables or the book off
+    if (arguments >> name && name == "book") {
+        std::string path;
+        std::shared_ptr<OpeningBook> book = std::make_shared<OpeningBook>();
+        std::getline(arguments >> std::ws, path);
+
+        waitForSearch();
+
+        if (path.empty())
+            ai.setOpeningBook(nullptr);
+        else if (book->load(path))
+            ai.setOpeningBook(book);
+        else
+            send("error no opening book in " + path);
+
+        return;
+    }
+
+    if (name == "tablebase") {
+        std::string directory;
+        std::shared_ptr<Tablebase> tablebase = std::make_shared<Tablebase>();
+        std::getline(arguments >> std::ws, directory);
+
+        waitForSearch();
+
+        if (directory.empty())
+            ai.setTablebase(nullptr);
+        else if (tablebase->load(directory) > 0)
+            ai.setTablebase(tablebase);
+        else
+            send("error no tables in " + directory);
+
+        return;
+    }
+
+    if (!(arguments >> value) || value < (name == "quiescence" || name == "pvs" || name == "rootparallel" ? 0 : 1)) {
+        send("error invalid option");
+        return;
+    }
+
+    waitForSearch();
+
+    if (name == "hash")
+        ai.setHashSize(value);
+    else if (name == "threads") {
+        ai.setThreadCount(value);
+        mcts.setThreadCount(value);
+    }
+    else if (name == "quiescence")
+        ai.setQuiescence(value != 0);
+    else if (name == "pvs")
+        ai.setPrincipalVariationSearch(value != 0);
+    else if (name == "rootparallel")
+        mcts.setParallelism(value != 0 ? MCTS_ROOT_PARALLEL : MCTS_TREE_PARALLEL);
+    else
+        send("error unknown option " + name);
+}
+
+void EngineProtocol::go(std::istream& arguments) {
+    int plies = 5;
+    int timeLimit = 0;
+    unsigned long long nodes = 0;
+    unsigned long long playouts = 0;
+    bool isMinimax = false;
+    bool isMonteCarlo = false;
+    int heuristicIndex = 2;
+    std::string name, value;
+
+    while (arguments >> name >> value) {
+        if (name == "depth")
+            plies = std::atoi(value.c_str());
+        else if (name == "time")
+            timeLimit = std::atoi(value.c_str());
+        else if (name == "nodes")
+            nodes = std::strtoull(value.c_str(), nullptr, 10);
+        else if (name == "playouts")
+            playouts = std::strtoull(value.c_str(), nullptr, 10);
+        else if (name == "algorithm") {
+            isMinimax = value == "minimax";
+            isMonteCarlo = value == "mcts";
+        }
+        else if (name == "heuristic")
+            heuristicIndex = std::atoi(value.c_str());
+        else {
+            send("error unknown limit " + name);
+            return;
+        }
+    }
+
+    if (plies < 1 || plies >= MAX_PLY || timeLimit < 0 || heuristicIndex < 0 || heuristicIndex > 2) {
+        send("error search limits out of range");
+        return;
+    }
+
+    waitForSearch();
+
+    Move moves[MAX_MOVES];
+
+    if (position.generateMoves(side, moves) == 0) {
+        send("bestmove none");
+        return;
+    }
+
+    board.setPosition(position);
+    searchStart = std::chrono::steady_clock::now();
+
+    if (isMonteCarlo) {
+        mcts.setPlayoutLimit(playouts);
+        mcts.clearStopRequest();
+
+        searchThread = std::thread([=] {
+            Move move = mcts.getNextMoveFromMCTS(side, timeLimit);
+
+            send("bestmove " + moveName(move) + " score " + std::to_string(mcts.getScore())
+                 + " depth " + std::to_string(mcts.getCompletedDepth())
+                 + " nodes " + std::to_string(mcts.getNodeCount())
+                 + " playouts " + std::to_string(mcts.getPlayoutCount())
+                 + " pps " + std::to_string(static_cast<long long>(mcts.getPlayoutsPerSecond()))
+                 + " time " + std::to_string(getElapsedMs()));
+        });
+        return;
+    }
+
+    ai.setNodeLimit(nodes);
+    ai.clearStopRequest();
+
+    searchThread = std::thread([=] {
+        Move move = ai.getNextMoveFromAI(plies + 1, side, isMinimax, heuristicIndex, timeLimit);
+
+        send("bestmove " + moveName(move) + " score " + std::to_string(ai.getScore())
+             + " depth " + std::to_string(ai.getCompletedDepth())
+             + " nodes " + std::to_string(ai.getNodeCount())
+             + " qnodes " + std::to_string(ai.getQuiescenceNodeCount())
+             + " time " + std::to_string(getElapsedMs()));
+    });
+}
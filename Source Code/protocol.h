@@ -0,0 +1,86 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "ai.h"
+#include "mcts.h"
+
+/* Line protocol of the engine process (bonzee --protocol). Moves and
+ * positions are written as in notation.h, scores are green minus red.
+ *
+ * commands, one per line:
+ *   position <start|rows> <R|G> [moves <move>...]
+ *                          sets the position and its side to move, the
+ *                          moves are played from it with alternating sides
+ *   setoption <hash|threads|quiescence|pvs|rootparallel> <value>
+ *                          quiescence 0 turns the capture search past the
+ *                          leaves of alpha-beta off, 1 back on, pvs 0 the
+ *                          null window and aspiration searches; rootparallel
+ *                          1 gives every mcts thread a tree of its own
+ *   setoption tablebase [<directory>]
+ *                          probes the endgame tables written by tbgen there,
+ *                          without a directory searches without them
+ *   setoption book [<file>]
+ *                          plays the positions of the opening book written
+ *                          by bookgen from it, without a file searches them
+ *   go [depth <plies>] [time <ms>] [nodes <n>] [playouts <n>]
+ *      [algorithm <minimax|alphabeta|mcts>] [heuristic <0|1|2>]
+ *                          searches the position, depth 5 and no limit by
+ *                          default; mcts reads only time and playouts
+ *   stop                   ends the search with the best move found so far
+ *   isready                answered by readyok
+ *   quit
+ *
+ * replies:
+ *   info depth <plies> score <score> nodes <n> time <ms> pv <move>...
+ *                          after every iteration the search completes, pv
+ *                          is the line it expects, the best move first
+ *   bestmove <move> score <score> depth <plies> nodes <n> qnodes <n> time <ms>
+ *                          once for every go, "bestmove none" when the
+ *                          side to move has no move; qnodes are the nodes
+ *                          of the capture search, part of nodes
+ *   bestmove <move> score <score> depth <plies> nodes <n> playouts <n> pps <n> time <ms>
+ *                          for an mcts search, score is from 100 (green
+ *                          wins) to -100, depth the deepest path of the
+ *                          tree and nodes its size
+ *   error <message>        for a command that cannot be read
+ *
+ * The search runs on its own thread so stop is read while it thinks, any
+ * other command waits for the search to finish first. */
+class EngineProtocol
+{
+private:
+    std::ostream& output;
+    std::mutex outputMutex;
+
+    Position position;
+    char side;
+    Board board;
+    AIPlayer ai;
+    MCTSPlayer mcts;
+
+    std::thread searchThread;
+    std::chrono::steady_clock::time_point searchStart;
+
+    void send(const std::string& line);
+    void waitForSearch();
+    long long getElapsedMs();
+
+    void setPosition(std::istream& arguments);
+    void setOption(std::istream& arguments);
+    void go(std::istream& arguments);
+
+public:
+    explicit EngineProtocol(std::ostream& output);
+    ~EngineProtocol();
+
+    // false once the engine is asked to quit
+    bool handleLine(const std::string& line);
+};
+
+#endif // PROTOCOL_H
@@ -0,0 +1,58 @@
+#include "searchstats.h"
+
+#include <cstdio>
+
+double SearchStats::getBranchingFactor() const {
+    size_t count = iterations.size();
+
+    if (count < 2 || iterations[count - 2].nodes == 0)
+        return 0;
+
+    return static_cast<double>(iterations[count - 1].nodes) / iterations[count - 2].nodes;
+}
+
+/**
+ * @brief statsLine, writes the statistics of a search as a JSON object on one line, so
+ *        a log of them holds one move per line
+ * @param stats, the statistics of the search
+ * @return the line, without the line break
+ */
+
+std::string statsLine(const SearchStats& stats) {
+    char buffer[512];
+    std::string line;
+
+    snprintf(buffer, sizeof(buffer),
+             "{\"algorithm\": \"%s\", \"heuristic\": %d, \"side\": \"%c\", \"move\": \"%s\", \"score\": %d, "
+             "\"depth\": %d, \"ms\": %.3f, \"ponderHit\": %s, \"nodes\": %llu, \"qnodes\": %llu, \"evaluations\": %llu, "
+             "\"cutoffs\": %llu, \"cutoffsAtMove\": [",
+             stats.algorithm.c_str(), stats.heuristicIndex, stats.side, stats.move.c_str(), stats.score,
+             stats.depth, stats.ms, stats.ponderHit ? "true" : "false",
+             static_cast<unsigned long long>(stats.nodes), static_cast<unsigned long long>(stats.quiescenceNodes),
+             static_cast<unsigned long long>(stats.leafEvaluations), static_cast<unsigned long long>(stats.cutoffs));
+    line += buffer;
+
+    for (int i = 0; i < CUTOFF_SLOTS; i++) {
+        snprintf(buffer, sizeof(buffer), "%s%llu", i == 0 ? "" : ", ",
+                 static_cast<unsigned long long>(stats.cutoffsAtMove[i]));
+        line += buffer;
+    }
+
+    snprintf(buffer, sizeof(buffer),
+             "], \"hashProbes\": %llu, \"hashHits\": %llu, \"researches\": %llu, \"playouts\": %llu, "
+             "\"tbHits\": %llu, \"ebf\": %.3f, \"traceBytes\": %llu, \"iterations\": [",
+             static_cast<unsigned long long>(stats.hashProbes), static_cast<unsigned long long>(stats.hashHits),
+             static_cast<unsigned long long>(stats.researches), static_cast<unsigned long long>(stats.playouts),
+             static_cast<unsigned long long>(stats.tablebaseHits),
+             stats.getBranchingFactor(), static_cast<unsigned long long>(stats.tracePeakBytes));
+    line += buffer;
+
+    for (size_t i = 0; i < stats.iterations.size(); i++) {
+        snprintf(buffer, sizeof(buffer), "%s{\"depth\": %d, \"nodes\": %llu, \"ms\": %.3f}", i == 0 ? "" : ", ",
+                 stats.iterations[i].depth, static_cast<unsigned long long>(stats.iterations[i].nodes),
+                 stats.iterations[i].ms);
+        line += buffer;
+    }
+
+    return line + "]}";
+}
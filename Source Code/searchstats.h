@@ -0,0 +1,59 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "moveorder.h"
+
+// One iteration of iterative deepening, its own nodes and time
+struct IterationStats {
+    int depth;
+    uint64_t nodes;
+    double ms;
+};
+
+/* Statistics of the search behind one move of the AI, kept by the player
+ * that searched it until its next search. Nodes, evaluations, hash
+ * counts and tablebase hits cover the main search and its helpers, the
+ * cutoffs and the iterations only the main search; cutoffsAtMove[i] counts
+ * the cutoffs caused by the i-th move searched at a node, the last slot
+ * those of every later one. A Monte Carlo search fills the nodes of its
+ * tree, its playouts and deepest path and leaves the rest at 0, a move
+ * played from the endgame tables is the algorithm "tablebase" with one
+ * hit and nothing else, one from the opening book the algorithm "book"
+ * with the score the book holds. */
+struct SearchStats {
+    std::string algorithm;
+    int heuristicIndex = 0;
+    char side = 'G';
+    std::string move;
+    int score = 0;
+    int depth = 0;
+    double ms = 0;
+    bool ponderHit = false;
+
+    uint64_t nodes = 0;
+    uint64_t quiescenceNodes = 0;
+    uint64_t leafEvaluations = 0;
+    uint64_t cutoffs = 0;
+    uint64_t cutoffsAtMove[CUTOFF_SLOTS] = {};
+    uint64_t hashProbes = 0;
+    uint64_t hashHits = 0;
+    uint64_t researches = 0;
+    uint64_t playouts = 0;
+    uint64_t tablebaseHits = 0;
+    size_t tracePeakBytes = 0; //Largest memory the search trees held at once
+
+    std::vector<IterationStats> iterations;
+
+    // nodes of the last iteration over those of the one before, 0 with fewer than two
+    double getBranchingFactor() const;
+};
+
+// the statistics as one line of JSON, without the line break
+std::string statsLine(const SearchStats& stats);
+
+#endif // SEARCHSTATS_H
@@ -0,0 +1,43 @@
+#include "searchtrace.h"
+
+void SearchTrace::clear() {
+    nodes.clear();
+}
+
+int SearchTrace::addRoot() {
+    nodes.push_back({0, -1, -1, 0, -1, -1});
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+/**
+ * @brief SearchTrace::expand, reserves the range of children of a node before
+ *        the search visits them, deeper nodes are appended after it
+ * @param node, the node being searched
+ * @param moveCount, the number of moves generated at the node
+ */
+
+void SearchTrace::expand(int node, int moveCount) {
+    nodes[node].firstChild = static_cast<int>(nodes.size());
+    nodes[node].childCount = 0;
+    nodes.resize(nodes.size() + moveCount);
+}
+
+/**
+ * @brief SearchTrace::addChild, takes the next child of the node's range
+ * @param node, the expanded parent
+ * @param move, the move leading to the child
+ * @return the index of the child
+ */
+
+int SearchTrace::addChild(int node, const Move& move) {
+    int child = nodes[node].firstChild + nodes[node].childCount++;
+    nodes[child] = {0, node, -1, 0, move.from, move.to};
+
+    return child;
+}
+
+int SearchTrace::getRow(int index) const {
+    const TraceNode& node = nodes[index];
+
+    return node.parent < 0 ? 0 : index - nodes[node.parent].firstChild;
+}
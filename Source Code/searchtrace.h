@@ -0,0 +1,44 @@
+#ifndef SEARCHTRACE_H
+#define SEARCHTRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "move.h"
+
+/* A node of the search tree, kept for display. The children of a node
+ * are the range firstChild..firstChild+childCount-1 of the trace. */
+struct TraceNode {
+    int32_t score;
+    int32_t parent;         // -1 for the root
+    int32_t firstChild;     // -1 until the node is expanded
+    int16_t childCount;     // children searched, a cutoff leaves the rest of the range unused
+    int8_t from;            // move leading to the node, -1 for the root
+    int8_t to;
+};
+
+/* Search tree of one iteration in a single array of nodes. The array keeps
+ * its memory when cleared, so a search reusing a trace allocates nothing
+ * once the array has grown to the size of its tree. */
+class SearchTrace
+{
+private:
+    std::vector<TraceNode> nodes;
+
+public:
+    void clear();
+
+    int addRoot();
+    void expand(int node, int moveCount);
+    int addChild(int node, const Move& move);
+    void setScore(int node, int score) { nodes[node].score = score; }
+
+    const TraceNode& getNode(int index) const { return nodes[index]; }
+    int getRow(int index) const;
+    int getSize() const { return static_cast<int>(nodes.size()); }
+    bool isEmpty() const { return nodes.empty(); }
+    size_t getMemoryUsage() const { return nodes.capacity() * sizeof(TraceNode); }
+};
+
+#endif // SEARCHTRACE_H
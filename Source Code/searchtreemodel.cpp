@@ -0,0 +1,76 @@
+#include "searchtreemodel.h"
+#include "position.h"
+
+SearchTreeModel::SearchTreeModel(QObject *parent) : QAbstractItemModel(parent)
+{
+}
+
+/**
+ * @brief SearchTreeModel::setTrace, replaces the displayed tree
+ * @param searchTrace, the trace of the last move, nullptr clears the view
+ */
+
+void SearchTreeModel::setTrace(std::shared_ptr<const SearchTrace> searchTrace) {
+    beginResetModel();
+    trace = searchTrace;
+    endResetModel();
+}
+
+QModelIndex SearchTreeModel::index(int row, int column, const QModelIndex &parent) const {
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+
+    if (!parent.isValid())
+        return createIndex(row, column, quintptr(0));
+
+    const TraceNode& node = trace->getNode(int(parent.internalId()));
+
+    return createIndex(row, column, quintptr(node.firstChild + row));
+}
+
+QModelIndex SearchTreeModel::parent(const QModelIndex &child) const {
+    if (!child.isValid())
+        return QModelIndex();
+
+    int parentNode = trace->getNode(int(child.internalId())).parent;
+
+    if (parentNode < 0)
+        return QModelIndex();
+
+    return createIndex(trace->getRow(parentNode), 0, quintptr(parentNode));
+}
+
+int SearchTreeModel::rowCount(const QModelIndex &parent) const {
+    if (!trace || trace->isEmpty() || parent.column() > 0)
+        return 0;
+
+    if (!parent.isValid())
+        return 1;
+
+    return trace->getNode(int(parent.internalId())).childCount;
+}
+
+int SearchTreeModel::columnCount(const QModelIndex &) const {
+    return 1;
+}
+
+/**
+ * @brief SearchTreeModel::data, the score of a node and the move leading to it,
+ *        written with the names of the board buttons
+ */
+
+QVariant SearchTreeModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const TraceNode& node = trace->getNode(int(index.internalId()));
+
+    if (node.from < 0)
+        return QString::number(node.score);
+
+    return QString::number(node.score)
+            + QString::fromStdString("   ")
+            + QChar('A' + Position::getY(node.from)) + QString::number(Position::getX(node.from) + 1)
+            + QString::fromStdString(" to ")
+            + QChar('A' + Position::getY(node.to)) + QString::number(Position::getX(node.to) + 1);
+}
@@ -0,0 +1,34 @@
+#ifndef SEARCHTREEMODEL_H
+#define SEARCHTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <memory>
+
+#include "searchtrace.h"
+
+/**
+ * Shows the search tree of the AI's last move in a QTreeView. Rows are not
+ * copied out of the trace: the view asks for the rows of a node only once
+ * the user expands it, and the model index of a row is the node's index in
+ * the trace.
+ */
+class SearchTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    explicit SearchTreeModel(QObject *parent = 0);
+
+    void setTrace(std::shared_ptr<const SearchTrace> searchTrace);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    std::shared_ptr<const SearchTrace> trace;
+};
+
+#endif // SEARCHTREEMODEL_H
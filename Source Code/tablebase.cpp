@@ -0,0 +1,505 @@
+#include "tablebase.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// Binomial coefficients up to C(45, TABLEBASE_MAX_TOKENS), the ranks of the index are sums of them
+struct BinomialTable {
+    uint64_t value[BOARD_SQUARES + 1][TABLEBASE_MAX_TOKENS + 1];
+
+    constexpr BinomialTable() : value() {
+        for (int n = 0; n <= BOARD_SQUARES; ++n) {
+            value[n][0] = 1;
+
+            for (int k = 1; k <= TABLEBASE_MAX_TOKENS; ++k)
+                value[n][k] = n == 0 ? 0 : value[n - 1][k - 1] + value[n - 1][k];
+        }
+    }
+};
+
+static constexpr BinomialTable BINOMIAL{};
+
+/**
+ * @brief rankSquares, rank of a set of squares among every set of the same size,
+ *        the sum of C(square, i) over its squares in ascending order, i from 1
+ * @param squares, the set
+ * @param skipped, squares left out of the numbering, the ones above them move down
+ */
+
+static uint64_t rankSquares(uint64_t squares, uint64_t skipped) {
+    uint64_t rank = 0;
+    int i = 1;
+
+    while (squares) {
+        int square = firstSquare(squares);
+        squares &= squares - 1;
+
+        square -= popCount(skipped & (squareBit(square) - 1));
+        rank += BINOMIAL.value[square][i++];
+    }
+
+    return rank;
+}
+
+/**
+ * @brief unrankSquares, the set of count squares of the given rank
+ * @param skipped, squares left out of the numbering, as for rankSquares
+ */
+
+static uint64_t unrankSquares(uint64_t rank, int count, uint64_t skipped) {
+    int available = BOARD_SQUARES - popCount(skipped);
+    uint64_t numbers = 0;
+
+    // the largest number first, the one of the highest C(number, i) that fits the rank
+    for (int i = count; i > 0; --i) {
+        int number = available - 1;
+
+        while (BINOMIAL.value[number][i] > rank)
+            number--;
+
+        rank -= BINOMIAL.value[number][i];
+        numbers |= squareBit(number);
+        available = number;
+    }
+
+    // the numbers count the squares that are not skipped
+    uint64_t squares = 0;
+    int number = 0;
+
+    for (int square = 0; square < BOARD_SQUARES && numbers; ++square) {
+        if (skipped & squareBit(square))
+            continue;
+
+        if (numbers & squareBit(number)) {
+            squares |= squareBit(square);
+            numbers &= ~squareBit(number);
+        }
+
+        number++;
+    }
+
+    return squares;
+}
+
+uint64_t tablebaseSize(int moverTokens, int otherTokens) {
+    return BINOMIAL.value[BOARD_SQUARES][moverTokens] * BINOMIAL.value[BOARD_SQUARES - moverTokens][otherTokens];
+}
+
+uint64_t tablebaseIndex(uint64_t mover, uint64_t other) {
+    int moverTokens = popCount(mover);
+    int otherTokens = popCount(other);
+
+    return rankSquares(mover, 0) * BINOMIAL.value[BOARD_SQUARES - moverTokens][otherTokens] + rankSquares(other, mover);
+}
+
+void tablebasePosition(uint64_t index, int moverTokens, int otherTokens, uint64_t& mover, uint64_t& other) {
+    uint64_t otherSets = BINOMIAL.value[BOARD_SQUARES - moverTokens][otherTokens];
+
+    mover = unrankSquares(index / otherSets, moverTokens, 0);
+    other = unrankSquares(index % otherSets, otherTokens, mover);
+}
+
+std::string tablebaseFileName(const std::string& directory, int moverTokens, int otherTokens) {
+    std::string name = std::to_string(moverTokens) + "v" + std::to_string(otherTokens) + ".bztb";
+
+    if (directory.empty())
+        return name;
+
+    return directory + "/" + name;
+}
+
+/**
+ * @brief codeLengths, bits of the Huffman code of each entry value from how often it occurs;
+ *        while a code is longer than TABLEBASE_MAX_CODE_BITS the counts are halved and the
+ *        code built again, which evens out the lengths
+ * @param counts, entries of each value
+ * @param bits, the length of each code, 0 for the values no entry has
+ */
+
+static void codeLengths(const uint64_t* counts, uint8_t* bits) {
+    std::vector<uint64_t> weights(counts, counts + TABLEBASE_VALUES);
+
+    while (true) {
+        // the two lightest nodes are joined until one is left, joined nodes are numbered from 256 on
+        typedef std::pair<uint64_t, int> Node;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> nodes;
+        std::vector<int> parent(2 * TABLEBASE_VALUES, -1);
+        int joined = TABLEBASE_VALUES;
+
+        for (int value = 0; value < TABLEBASE_VALUES; ++value) {
+            bits[value] = 0;
+
+            if (weights[value] > 0)
+                nodes.push(Node(weights[value], value));
+        }
+
+        // a single value still needs a code of one bit
+        if (nodes.size() == 1) {
+            bits[nodes.top().second] = 1;
+            return;
+        }
+
+        while (nodes.size() > 1) {
+            Node first = nodes.top();
+            nodes.pop();
+            Node second = nodes.top();
+            nodes.pop();
+
+            parent[first.second] = joined;
+            parent[second.second] = joined;
+            nodes.push(Node(first.first + second.first, joined++));
+        }
+
+        int longest = 0;
+
+        for (int value = 0; value < TABLEBASE_VALUES; ++value) {
+            if (weights[value] == 0)
+                continue;
+
+            for (int node = value; parent[node] >= 0; node = parent[node])
+                bits[value]++;
+
+            longest = std::max(longest, static_cast<int>(bits[value]));
+        }
+
+        if (longest <= TABLEBASE_MAX_CODE_BITS)
+            return;
+
+        for (int value = 0; value < TABLEBASE_VALUES; ++value)
+            weights[value] = weights[value] == 0 ? 0 : (weights[value] + 1) / 2;
+    }
+}
+
+/**
+ * @brief writeTablebase, codes a table and writes it with its header and block offsets
+ * @param path, the file, replaced when it exists
+ * @param entries, the entries of the table in index order
+ * @return whether the whole file was written
+ */
+
+bool writeTablebase(const std::string& path, int moverTokens, int otherTokens, const uint8_t* entries) {
+    uint64_t size = tablebaseSize(moverTokens, otherTokens);
+    uint32_t blockCount = static_cast<uint32_t>((size + TABLEBASE_BLOCK_SIZE - 1) / TABLEBASE_BLOCK_SIZE);
+    uint64_t counts[TABLEBASE_VALUES] = {};
+    int longest = 0;
+
+    for (uint64_t i = 0; i < size; ++i)
+        counts[entries[i]]++;
+
+    TablebaseHeader header;
+    memcpy(header.magic, "BZTB", 4);
+    header.version = TABLEBASE_VERSION;
+    header.moverTokens = moverTokens;
+    header.otherTokens = otherTokens;
+    header.entries = size;
+    header.blockCount = blockCount;
+    codeLengths(counts, header.codeBits);
+
+    // canonical codes, shorter codes first and values in order within a length, as in deflate
+    int lengthCount[TABLEBASE_MAX_CODE_BITS + 1] = {};
+    uint32_t nextCode[TABLEBASE_MAX_CODE_BITS + 1] = {};
+    uint32_t codes[TABLEBASE_VALUES] = {};
+
+    for (int value = 0; value < TABLEBASE_VALUES; ++value) {
+        if (header.codeBits[value] > 0)
+            lengthCount[header.codeBits[value]]++;
+
+        if (counts[value] > 0)
+            longest = value;
+    }
+
+    for (int bits = 1; bits <= TABLEBASE_MAX_CODE_BITS; ++bits)
+        nextCode[bits] = (nextCode[bits - 1] + lengthCount[bits - 1]) << 1;
+
+    for (int value = 0; value < TABLEBASE_VALUES; ++value) {
+        if (header.codeBits[value] > 0)
+            codes[value] = nextCode[header.codeBits[value]]++;
+    }
+
+    header.maxDistance = longest == 0 ? 0 : longest - 1;
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint8_t> blocks;
+    uint64_t buffer = 0; //Bits not written yet, the last buffered of them
+    int buffered = 0;
+
+    offsets.reserve(blockCount + 1);
+
+    for (uint64_t i = 0; i < size; ++i) {
+        if (i % TABLEBASE_BLOCK_SIZE == 0) {
+            offsets.push_back(static_cast<uint32_t>(blocks.size()));
+            buffer = 0;
+            buffered = 0;
+        }
+
+        buffer = buffer << header.codeBits[entries[i]] | codes[entries[i]];
+        buffered += header.codeBits[entries[i]];
+
+        while (buffered >= 8) {
+            blocks.push_back(static_cast<uint8_t>(buffer >> (buffered - 8)));
+            buffered -= 8;
+        }
+
+        // a block ends on a byte, padded with zeros
+        if ((i + 1) % TABLEBASE_BLOCK_SIZE == 0 || i + 1 == size) {
+            if (buffered > 0)
+                blocks.push_back(static_cast<uint8_t>(buffer << (8 - buffered)));
+        }
+    }
+
+    offsets.push_back(static_cast<uint32_t>(blocks.size()));
+
+    FILE* file = fopen(path.c_str(), "wb");
+
+    if (!file)
+        return false;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+                && fwrite(offsets.data(), sizeof(uint32_t), offsets.size(), file) == offsets.size()
+                && fwrite(blocks.data(), 1, blocks.size(), file) == blocks.size();
+
+    return fclose(file) == 0 && written;
+}
+
+int tablebaseScore(const TablebaseEntry& entry, char player) {
+    if (entry.result == 0)
+        return 0;
+
+    int score = entry.result * (TABLEBASE_WIN_SCORE - entry.distance);
+    return player == 'G' ? score : -score;
+}
+
+Tablebase::Tablebase() : tableCount(0), maxTokens(0)
+{
+}
+
+/**
+ * @brief Tablebase::mapTable, maps a table file and checks it is the table it is named after
+ * @return whether the table can be probed
+ */
+
+bool Tablebase::mapTable(Table& table, const std::string& path, int moverTokens, int otherTokens) {
+    if (!table.file.open(path))
+        return false;
+
+    const uint8_t* data = table.file.getData();
+    size_t size = table.file.getSize();
+    const TablebaseHeader* header = reinterpret_cast<const TablebaseHeader*>(data);
+    uint64_t entries = tablebaseSize(moverTokens, otherTokens);
+    uint64_t blockCount = (entries + TABLEBASE_BLOCK_SIZE - 1) / TABLEBASE_BLOCK_SIZE;
+    size_t blocksStart = sizeof(TablebaseHeader) + (blockCount + 1) * sizeof(uint32_t);
+
+    bool valid = size >= sizeof(TablebaseHeader) && memcmp(header->magic, "BZTB", 4) == 0
+            && header->version == TABLEBASE_VERSION && header->moverTokens == static_cast<uint32_t>(moverTokens)
+            && header->otherTokens == static_cast<uint32_t>(otherTokens) && header->entries == entries
+            && header->blockCount == blockCount && size >= blocksStart;
+
+    const uint32_t* offsets = reinterpret_cast<const uint32_t*>(data + sizeof(TablebaseHeader));
+
+    for (uint64_t block = 0; valid && block < blockCount; ++block)
+        valid = offsets[block] < offsets[block + 1];
+
+    // the code lengths have to make up a whole prefix code, or a single code of one bit
+    uint64_t codeSpace = 0;
+    int position[TABLEBASE_MAX_CODE_BITS + 1] = {};
+
+    for (int bits = 0; bits <= TABLEBASE_MAX_CODE_BITS; ++bits)
+        table.codeCount[bits] = 0;
+
+    for (int value = 0; valid && value < TABLEBASE_VALUES; ++value) {
+        int bits = header->codeBits[value];
+        valid = bits <= TABLEBASE_MAX_CODE_BITS;
+
+        if (valid && bits > 0) {
+            table.codeCount[bits]++;
+            codeSpace += 1ULL << (TABLEBASE_MAX_CODE_BITS - bits);
+        }
+    }
+
+    valid = valid && (codeSpace == 1ULL << TABLEBASE_MAX_CODE_BITS
+                      || (codeSpace == 1ULL << (TABLEBASE_MAX_CODE_BITS - 1) && table.codeCount[1] == 1));
+
+    if (!valid || offsets[blockCount] > size - blocksStart) {
+        table.file.close();
+        return false;
+    }
+
+    for (int bits = 1; bits < TABLEBASE_MAX_CODE_BITS; ++bits)
+        position[bits + 1] = position[bits] + table.codeCount[bits];
+
+    for (int value = 0; value < TABLEBASE_VALUES; ++value) {
+        if (header->codeBits[value] > 0)
+            table.codeValues[position[header->codeBits[value]]++] = static_cast<uint8_t>(value);
+    }
+
+    table.header = header;
+    table.offsets = offsets;
+    table.blocks = data + blocksStart;
+    return true;
+}
+
+/**
+ * @brief Tablebase::load, maps every table of a directory
+ * @param directory, where tbgen wrote the tables
+ * @return the number of tables mapped
+ */
+
+int Tablebase::load(const std::string& directory) {
+    unload();
+
+    for (int mover = 1; mover <= TABLEBASE_MAX_TOKENS; ++mover) {
+        for (int other = 1; other <= TABLEBASE_MAX_TOKENS; ++other) {
+            if (mapTable(tables[mover - 1][other - 1], tablebaseFileName(directory, mover, other), mover, other))
+                tableCount++;
+        }
+    }
+
+    // a position leads only to positions with fewer tokens, so the tables
+    // are probed up to the material every table below it is loaded for
+    while (maxTokens < TABLEBASE_MAX_TOKENS) {
+        bool complete = true;
+
+        for (int i = 0; i <= maxTokens; ++i)
+            complete = complete && tables[maxTokens][i].header && tables[i][maxTokens].header;
+
+        if (!complete)
+            break;
+
+        maxTokens++;
+    }
+
+    return tableCount;
+}
+
+void Tablebase::unload() {
+    for (int mover = 0; mover < TABLEBASE_MAX_TOKENS; ++mover) {
+        for (int other = 0; other < TABLEBASE_MAX_TOKENS; ++other) {
+            tables[mover][other].file.close();
+            tables[mover][other].header = nullptr;
+        }
+    }
+
+    tableCount = 0;
+    maxTokens = 0;
+}
+
+int Tablebase::getTableCount() const {
+    return tableCount;
+}
+
+int Tablebase::getMaxTokens() const {
+    return maxTokens;
+}
+
+/**
+ * @brief Tablebase::readEntry, decodes the block of an entry up to the entry, one bit at a time
+ */
+
+uint8_t Tablebase::readEntry(const Table& table, uint64_t index) const {
+    const uint8_t* code = table.blocks + table.offsets[index / TABLEBASE_BLOCK_SIZE];
+    int remaining = static_cast<int>(index % TABLEBASE_BLOCK_SIZE);
+    int byte = 0;
+    int bitsLeft = 0;
+
+    while (true) {
+        // codeWord is read against the first code of each length, first, and the values
+        // of the shorter codes, position; it is a code of its length when below first + count
+        int codeWord = 0;
+        int first = 0;
+        int position = 0;
+        int value = 0;
+
+        for (int bits = 1; bits <= TABLEBASE_MAX_CODE_BITS; ++bits) {
+            if (bitsLeft == 0) {
+                byte = *code++;
+                bitsLeft = 8;
+            }
+
+            codeWord |= (byte >> --bitsLeft) & 1;
+            int count = table.codeCount[bits];
+
+            if (codeWord - count < first) {
+                value = table.codeValues[position + codeWord - first];
+                break;
+            }
+
+            position += count;
+            first = (first + count) << 1;
+            codeWord <<= 1;
+        }
+
+        if (remaining-- == 0)
+            return static_cast<uint8_t>(value);
+    }
+}
+
+/**
+ * @brief Tablebase::probe, looks a position up in its table
+ * @param player, the side to move
+ * @param entry, the result for player when the position is found
+ * @return whether a table holds the position
+ */
+
+bool Tablebase::probe(const Position& position, char player, TablebaseEntry& entry) const {
+    uint64_t mover = position.getTokens(player);
+    uint64_t other = position.getTokens(player == 'G' ? 'R' : 'G');
+    int moverTokens = popCount(mover);
+    int otherTokens = popCount(other);
+
+    if (moverTokens > maxTokens || otherTokens > maxTokens || moverTokens == 0 || otherTokens == 0)
+        return false;
+
+    entry = decodeTablebaseEntry(readEntry(tables[moverTokens - 1][otherTokens - 1], tablebaseIndex(mover, other)));
+    return true;
+}
+
+/**
+ * @brief Tablebase::probeRoot, picks the move of the side to move from the results
+ *        of the positions its moves lead to
+ * @param position, the position, player to move
+ * @param move, the move keeping the best result
+ * @param entry, that result for player
+ * @return whether the tables hold the position and player has a move
+ */
+
+bool Tablebase::probeRoot(const Position& position, char player, Move& move, TablebaseEntry& entry) const {
+    char opponent = player == 'G' ? 'R' : 'G';
+    TablebaseEntry rootEntry;
+
+    if (!probe(position, player, rootEntry))
+        return false;
+
+    Move moves[MAX_MOVES];
+    int moveCount = position.generateMoves(player, moves);
+    int bestRank = 0;
+
+    for (int i = 0; i < moveCount; i++) {
+        Position child(position.getTokens('R'), position.getTokens('G'));
+        TablebaseEntry reply;
+        child.applyMove(moves[i]);
+
+        // a move taking the last token wins at once
+        if (child.getTokens(opponent) == 0)
+            reply = {-1, 0};
+        else if (!probe(child, opponent, reply))
+            return false;
+
+        TablebaseEntry result = {-reply.result, reply.result == 0 ? 0 : reply.distance + 1};
+
+        // fast wins first, then draws, then slow losses
+        int rank = result.result > 0 ? 2 * TABLEBASE_MAX_DISTANCE - result.distance
+                 : result.result == 0 ? 0 : result.distance - 2 * TABLEBASE_MAX_DISTANCE;
+
+        if (i == 0 || rank > bestRank) {
+            bestRank = rank;
+            move = moves[i];
+            entry = result;
+        }
+    }
+
+    return moveCount > 0;
+}
@@ -0,0 +1,130 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <cstdint>
+#include <string>
+
+#include "mappedfile.h"
+#include "position.h"
+
+/* Endgame tablebases, the exact result of every position with few tokens
+ * left, solved ahead of time by retrograde analysis (tools/tbgen). A table
+ * holds one material, the tokens of the side to move and of the other side
+ * whatever their colour, since the rules are the same for both. Positions
+ * are numbered by a perfect index: the rank of the mover's squares among
+ * the 45, then the rank of the other side's squares among the tiles left,
+ * so a table has no holes.
+ *
+ * An entry is one byte, 0 for a draw, otherwise the plies to the end of the
+ * game plus 1: an odd number of plies is a win for the side to move, an even
+ * one a loss. The game ends as the search sees it, a side without a move has
+ * lost; the stalemate rule is left out since it does not depend on the
+ * position alone.
+ *
+ * A table is a file <mover>v<other>.bztb: the header, the offset of every
+ * block from the end of the offsets, and the blocks, TABLEBASE_BLOCK_SIZE
+ * entries each. The entries are Huffman coded with a canonical code of the
+ * table, the header holds the length of the code of each entry value, and
+ * every block starts on a byte, its bits read from the high bit down. The
+ * files are mapped, not read, and a probe decodes the block of its entry
+ * only up to the entry. */
+
+// Most tokens per side of a table, 3 v 3 holds 163 million positions
+const int TABLEBASE_MAX_TOKENS = 3;
+// Entries coded together, the most a probe decodes
+const int TABLEBASE_BLOCK_SIZE = 256;
+// Longest code of an entry value
+const int TABLEBASE_MAX_CODE_BITS = 24;
+// Longest game a table can hold, in plies
+const int TABLEBASE_MAX_DISTANCE = 254;
+// Score of a won position, green minus red, less the plies to the end of the game
+const int TABLEBASE_WIN_SCORE = 500000;
+// Values an entry can take, each has a code of its own
+const int TABLEBASE_VALUES = 256;
+const uint32_t TABLEBASE_VERSION = 1;
+
+struct TablebaseHeader {
+    char magic[4];          // "BZTB"
+    uint32_t version;
+    uint32_t moverTokens;
+    uint32_t otherTokens;
+    uint64_t entries;
+    uint32_t blockCount;
+    uint32_t maxDistance;   // longest win or loss of the table in plies
+    uint8_t codeBits[TABLEBASE_VALUES]; // length of the code of each entry value, 0 when unused
+};
+
+// Result of a position for the side to move
+struct TablebaseEntry {
+    int result;     // 1 won, 0 drawn, -1 lost
+    int distance;   // plies to the end of the game, 0 for a draw
+};
+
+inline TablebaseEntry decodeTablebaseEntry(uint8_t value) {
+    if (value == 0)
+        return {0, 0};
+
+    return {(value - 1) % 2 == 1 ? 1 : -1, value - 1};
+}
+
+// positions of a table, and the index of a position in its table from
+// the token masks of the side to move and of the other side
+uint64_t tablebaseSize(int moverTokens, int otherTokens);
+uint64_t tablebaseIndex(uint64_t mover, uint64_t other);
+void tablebasePosition(uint64_t index, int moverTokens, int otherTokens, uint64_t& mover, uint64_t& other);
+
+std::string tablebaseFileName(const std::string& directory, int moverTokens, int otherTokens);
+
+// writes the tablebaseSize(moverTokens, otherTokens) entries of a table,
+// false when the file cannot be written
+bool writeTablebase(const std::string& path, int moverTokens, int otherTokens, const uint8_t* entries);
+
+// the entry as a score of the search, green minus red, player is the side to move
+int tablebaseScore(const TablebaseEntry& entry, char player);
+
+class Tablebase
+{
+private:
+    // a table and its code, as decoded by puff of zlib: the codes of each
+    // length are consecutive, the values in the order of their codes
+    struct Table {
+        MappedFile file;
+        const TablebaseHeader* header = nullptr;
+        const uint32_t* offsets = nullptr;
+        const uint8_t* blocks = nullptr;
+        int codeCount[TABLEBASE_MAX_CODE_BITS + 1];
+        uint8_t codeValues[TABLEBASE_VALUES];
+    };
+
+    Table tables[TABLEBASE_MAX_TOKENS][TABLEBASE_MAX_TOKENS];
+    int tableCount;
+    int maxTokens; //Every table up to this many tokens per side is loaded
+
+    bool mapTable(Table& table, const std::string& path, int moverTokens, int otherTokens);
+    uint8_t readEntry(const Table& table, uint64_t index) const;
+
+public:
+    Tablebase();
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    // maps the tables of directory, those loaded before are closed;
+    // returns the number of tables found, files that do not check
+    // out against their name are left out
+    int load(const std::string& directory);
+    void unload();
+    int getTableCount() const;
+    int getMaxTokens() const;
+
+    // result of the position with player to move, false when the
+    // tables do not hold it or the game is already over
+    bool probe(const Position& position, char player, TablebaseEntry& entry) const;
+
+    // the move of player keeping the best result, the fastest win, a
+    // draw or the slowest loss, the first one in move order of equals;
+    // false when the tables do not hold the position or player cannot move
+    bool probeRoot(const Position& position, char player, Move& move, TablebaseEntry& entry) const;
+};
+
+#endif // TABLEBASE_H
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Search benchmark, fixed depth searches of a
+# position corpus, JSON output and baseline compare
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = bench
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS += -std=c++14
+
+include(../../engine/engine.pri)
+
+SOURCES += \
+        main.cpp
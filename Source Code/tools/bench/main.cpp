@@ -0,0 +1,419 @@
+#include "ai.h"
+#include "notation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Search benchmark, searches every position of a fixed corpus to a fixed
+ * depth with every algorithm and heuristic, single threaded from an empty
+ * transposition table, so the node counts repeat exactly from run to run.
+ * For each search it reports the nodes, those of the capture search past
+ * the leaves among them, nodes per second, the effective branching factor
+ * (nodes of the last iteration over those of the one before), the wall
+ * time, the time to reach each depth and the move chosen.
+ *
+ * The results can be written as JSON, one result object per line, and a
+ * results file written earlier can be given as the baseline to compare
+ * against; a search that needs more nodes or runs slower than the baseline
+ * by more than the tolerance is a regression and the exit code is 1.
+ * Run with --help for the options. */
+
+// Searches faster than this in the baseline are too short to compare their speed
+const double MIN_TIMED_MS = 10;
+
+struct CorpusPosition {
+    const char* name;
+    const char* rows;
+    char side;
+};
+
+// from the start through midgames to endgames with a few tokens left
+static const CorpusPosition CORPUS[] = {
+    {"start", "start", 'G'},
+    {"midgame1", "RRXRRXRRR/RXRRGRXRR/GGXGXRRXR/GXGGRGXGG/GGXGGGGXG", 'G'},
+    {"midgame2", "RXRXXRXRX/RXRRRXXXX/GXXXXXGXX/GGGXXRXGX/XGGGXGGGG", 'G'},
+    {"midgame3", "XXXRXRXRR/RXXXXRXXR/XXXXGXGRX/XXGGGXXXG/XGGGXXGXG", 'G'},
+    {"midgame4", "RXXXRRXXR/RRXXXXXXX/GXXXXXRXR/GXGXXXXGX/XGXGXGXGX", 'G'},
+    {"open", "RXXRXXRXR/XRXXGXXRX/GXXXXRXXR/XXGXGXXGX/GXXGXXGXG", 'R'},
+    {"endgame1", "RXXXXRXXX/XXXRXRXXX/XXXXXXXXX/XXXXXGXXX/XXGGXGGGG", 'R'},
+    {"endgame2", "XXXRXRXXR/XXXXXXXXX/XXRXXXXXX/XXXXXGXXR/XGXGXXXGX", 'R'},
+    {"endgame3", "XXXXXXXXX/XXRXXGXXX/RXXXXXXXX/XXXXXXXXX/XGXGXXXGG", 'G'},
+    {"endgame4", "XXXXXXXXX/XXXXGXGRX/XXXGXXXXX/XXXXXXXXX/XGXGXXXXX", 'G'}
+};
+
+struct Iteration {
+    int depth;
+    uint64_t nodes; //Nodes of the search up to this iteration
+    double ms; //Time to depth
+};
+
+struct BenchResult {
+    string position;
+    string algorithm;
+    int heuristicIndex;
+    int plies;
+    uint64_t nodes;
+    uint64_t quiescenceNodes;
+    double ms;
+    double nps;
+    double branchingFactor;
+    string move;
+    int score;
+    string principalVariation;
+    vector<Iteration> iterations;
+};
+
+static void printUsage() {
+    fprintf(stderr,
+            "usage: bench [options]\n"
+            "  -a, --algorithms <list>  minimax and/or alphabeta, default both\n"
+            "  -e, --heuristics <list>  0 = naive, 1 = counting, 2 = informed, default 0,1,2\n"
+            "  -d, --depth <plies>      depth of every search, default 4 for minimax and 6 for alphabeta\n"
+            "  -q, --quiescence <0|1>   play out captures past the leaves of alpha-beta, default 1\n"
+            "  -p, --pvs <0|1>          null window and aspiration searches in alpha-beta, default 1\n"
+            "  -r, --repeat <n>         searches per result, the fastest time is kept, default 3\n"
+            "  -o, --json <file>        write the results as JSON, - for stdout\n"
+            "  -c, --compare <file>     compare against results written earlier with --json\n"
+            "      --tolerance <pct>    slowdown or node increase flagged as a regression, default 10\n");
+}
+
+static bool isOption(const char* arg, const char* shortName, const char* longName) {
+    return (shortName != nullptr && strcmp(arg, shortName) == 0) || strcmp(arg, longName) == 0;
+}
+
+static vector<string> splitList(const char* value) {
+    vector<string> items;
+    stringstream stream(value);
+    string item;
+
+    while (getline(stream, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+
+    return items;
+}
+
+/**
+ * @brief runSearch, searches a corpus position from a fresh engine and times it
+ */
+
+static BenchResult runSearch(const CorpusPosition& corpus, const string& algorithm, int heuristicIndex, int plies,
+                             bool quiescence, bool principalVariationSearch) {
+    Position position;
+    parsePosition(corpus.rows, position);
+
+    Board board(position);
+    AIPlayer ai(&board);
+    ai.setTracing(false);
+    ai.setQuiescence(quiescence);
+    ai.setPrincipalVariationSearch(principalVariationSearch);
+
+    BenchResult result = {corpus.name, algorithm, heuristicIndex, plies, 0, 0, 0, 0, 0, "", 0, "", {}};
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    ai.setIterationCallback([&](int depth, int, uint64_t nodes, const Move&) {
+        result.iterations.push_back({depth, nodes, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count()});
+    });
+
+    Move move = ai.getNextMoveFromAI(plies + 1, corpus.side, algorithm == "minimax", heuristicIndex);
+    result.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    result.nodes = ai.getNodeCount();
+    result.quiescenceNodes = ai.getQuiescenceNodeCount();
+    result.nps = result.ms > 0 ? result.nodes / result.ms * 1000 : 0;
+    result.move = moveName(move);
+    result.score = ai.getScore();
+    result.principalVariation = lineName(ai.getPrincipalVariation());
+
+    size_t count = result.iterations.size();
+
+    if (count >= 2) {
+        double last = result.iterations[count - 1].nodes - result.iterations[count - 2].nodes;
+        double previous = result.iterations[count - 2].nodes - (count >= 3 ? result.iterations[count - 3].nodes : 0);
+        result.branchingFactor = previous > 0 ? last / previous : 0;
+    }
+    else
+        result.branchingFactor = pow(static_cast<double>(result.nodes), 1.0 / plies);
+
+    return result;
+}
+
+static void writeJson(FILE* file, const vector<BenchResult>& results, uint64_t totalNodes, double totalMs) {
+    fprintf(file, "{\n  \"results\": [\n");
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+
+        fprintf(file, "    {\"position\": \"%s\", \"algorithm\": \"%s\", \"heuristic\": %d, \"depth\": %d, "
+                      "\"nodes\": %llu, \"qnodes\": %llu, \"ms\": %.3f, \"nps\": %.0f, \"ebf\": %.3f, \"move\": \"%s\", \"score\": %d, \"pv\": \"%s\", \"iterations\": [",
+                result.position.c_str(), result.algorithm.c_str(), result.heuristicIndex, result.plies,
+                static_cast<unsigned long long>(result.nodes), static_cast<unsigned long long>(result.quiescenceNodes),
+                result.ms, result.nps, result.branchingFactor,
+                result.move.c_str(), result.score, result.principalVariation.c_str());
+
+        for (size_t j = 0; j < result.iterations.size(); ++j)
+            fprintf(file, "%s{\"depth\": %d, \"nodes\": %llu, \"ms\": %.3f}", j == 0 ? "" : ", ", result.iterations[j].depth,
+                    static_cast<unsigned long long>(result.iterations[j].nodes), result.iterations[j].ms);
+
+        fprintf(file, "]}%s\n", i + 1 < results.size() ? "," : "");
+    }
+
+    fprintf(file, "  ],\n  \"total\": {\"nodes\": %llu, \"ms\": %.3f, \"nps\": %.0f}\n}\n",
+            static_cast<unsigned long long>(totalNodes), totalMs, totalMs > 0 ? totalNodes / totalMs * 1000 : 0);
+}
+
+/**
+ * @brief readField, reads the value of a key on a result line of writeJson,
+ *        the first occurrence is the result's own, before its iterations
+ */
+
+static bool readField(const string& line, const string& key, string& value) {
+    size_t start = line.find("\"" + key + "\": ");
+
+    if (start == string::npos)
+        return false;
+
+    start += key.size() + 4;
+
+    if (line[start] == '"') {
+        size_t end = line.find('"', start + 1);
+        value = line.substr(start + 1, end - start - 1);
+    }
+    else
+        value = line.substr(start, line.find_first_of(",}", start) - start);
+
+    return true;
+}
+
+static string resultKey(const string& position, const string& algorithm, const string& heuristic, const string& depth) {
+    return position + " " + algorithm + " h" + heuristic + " d" + depth;
+}
+
+/**
+ * @brief compareResults, prints how every result differs from the baseline
+ * @param out, where the comparison is printed
+ * @return number of regressions, more nodes or fewer nodes per second than the tolerance allows,
+ *         speeds are only compared for searches of at least MIN_TIMED_MS
+ */
+
+static int compareResults(const char* path, const vector<BenchResult>& results, double tolerance, FILE* out) {
+    ifstream file(path);
+
+    if (!file) {
+        fprintf(stderr, "bench: cannot read %s\n", path);
+        return -1;
+    }
+
+    map<string, BenchResult> baseline;
+    string line;
+
+    while (getline(file, line)) {
+        string position, algorithm, heuristic, depth, nodes, ms, nps, move;
+
+        if (!readField(line, "position", position) || !readField(line, "algorithm", algorithm) || !readField(line, "heuristic", heuristic)
+                || !readField(line, "depth", depth) || !readField(line, "nodes", nodes) || !readField(line, "ms", ms)
+                || !readField(line, "nps", nps) || !readField(line, "move", move))
+            continue;
+
+        BenchResult& entry = baseline[resultKey(position, algorithm, heuristic, depth)];
+        entry.nodes = strtoull(nodes.c_str(), nullptr, 10);
+        entry.ms = atof(ms.c_str());
+        entry.nps = atof(nps.c_str());
+        entry.move = move;
+    }
+
+    int regressions = 0;
+    uint64_t nodes = 0, baselineNodes = 0;
+    double ms = 0, baselineMs = 0;
+    fprintf(out, "\ncompared with %s, tolerance %.0f%%\n", path, tolerance * 100);
+    fprintf(out, "%-32s %9s %9s  %s\n", "search", "nodes", "nps", "");
+
+    for (const BenchResult& result : results) {
+        string key = resultKey(result.position, result.algorithm, to_string(result.heuristicIndex), to_string(result.plies));
+        map<string, BenchResult>::const_iterator found = baseline.find(key);
+
+        if (found == baseline.end()) {
+            fprintf(out, "%-32s %9s %9s  not in baseline\n", key.c_str(), "", "");
+            continue;
+        }
+
+        const BenchResult& old = found->second;
+        double nodeChange = old.nodes > 0 ? static_cast<double>(result.nodes) / old.nodes - 1 : 0;
+        double npsChange = old.nps > 0 ? result.nps / old.nps - 1 : 0;
+        bool slower = old.ms >= MIN_TIMED_MS && npsChange < -tolerance;
+        string flags;
+
+        nodes += result.nodes;
+        ms += result.ms;
+        baselineNodes += old.nodes;
+        baselineMs += old.ms;
+
+        if (nodeChange > tolerance)
+            flags += " REGRESSION nodes";
+
+        if (slower)
+            flags += " REGRESSION nps";
+
+        if (result.move != old.move)
+            flags += " move " + old.move + " -> " + result.move;
+
+        regressions += (nodeChange > tolerance) + slower;
+        fprintf(out, "%-32s %+8.1f%% %+8.1f%% %s\n", key.c_str(), nodeChange * 100, npsChange * 100, flags.c_str());
+    }
+
+    // the speed over all searches also catches a slowdown spread over many short ones
+    double totalNps = ms > 0 ? nodes / ms : 0;
+    double baselineNps = baselineMs > 0 ? baselineNodes / baselineMs : 0;
+    double totalChange = baselineNps > 0 ? totalNps / baselineNps - 1 : 0;
+    bool slower = baselineMs >= MIN_TIMED_MS && totalChange < -tolerance;
+
+    regressions += slower;
+    fprintf(out, "%-32s %9s %+8.1f%% %s\n", "total", "", totalChange * 100, slower ? " REGRESSION nps" : "");
+    fprintf(out, "%d regression%s\n", regressions, regressions == 1 ? "" : "s");
+    return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+    vector<string> algorithms = {"minimax", "alphabeta"};
+    vector<string> heuristics = {"0", "1", "2"};
+    int plies = 0;
+    int repeat = 3;
+    bool quiescence = true;
+    bool principalVariationSearch = true;
+    const char* jsonPath = nullptr;
+    const char* baselinePath = nullptr;
+    double tolerance = 0.10;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if (isOption(arg, "-h", "--help")) {
+            printUsage();
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            fprintf(stderr, "bench: %s needs a value\n", arg);
+            printUsage();
+            return 1;
+        }
+
+        const char* value = argv[++i];
+
+        if (isOption(arg, "-a", "--algorithms"))
+            algorithms = splitList(value);
+        else if (isOption(arg, "-e", "--heuristics"))
+            heuristics = splitList(value);
+        else if (isOption(arg, "-d", "--depth"))
+            plies = atoi(value);
+        else if (isOption(arg, "-q", "--quiescence"))
+            quiescence = atoi(value) != 0;
+        else if (isOption(arg, "-p", "--pvs"))
+            principalVariationSearch = atoi(value) != 0;
+        else if (isOption(arg, "-r", "--repeat"))
+            repeat = atoi(value);
+        else if (isOption(arg, "-o", "--json"))
+            jsonPath = value;
+        else if (isOption(arg, "-c", "--compare"))
+            baselinePath = value;
+        else if (isOption(arg, nullptr, "--tolerance"))
+            tolerance = atof(value) / 100;
+        else {
+            fprintf(stderr, "bench: unknown option %s\n", arg);
+            printUsage();
+            return 1;
+        }
+    }
+
+    for (const string& algorithm : algorithms)
+        if (algorithm != "minimax" && algorithm != "alphabeta") {
+            fprintf(stderr, "bench: unknown algorithm %s\n", algorithm.c_str());
+            return 1;
+        }
+
+    for (const string& heuristic : heuristics)
+        if (heuristic != "0" && heuristic != "1" && heuristic != "2") {
+            fprintf(stderr, "bench: unknown heuristic %s\n", heuristic.c_str());
+            return 1;
+        }
+
+    if (plies < 0 || plies >= MAX_PLY || repeat < 1 || tolerance < 0) {
+        fprintf(stderr, "bench: limits out of range\n");
+        return 1;
+    }
+
+    // the table goes to stderr when the JSON is written to stdout
+    bool jsonToStdout = jsonPath != nullptr && strcmp(jsonPath, "-") == 0;
+    FILE* table = jsonToStdout ? stderr : stdout;
+
+    vector<BenchResult> results;
+    uint64_t totalNodes = 0;
+    double totalMs = 0;
+
+    fprintf(table, "%-9s %-9s %2s %5s %12s %10s %10s %10s %6s  %-6s %s\n",
+            "position", "algorithm", "h", "depth", "nodes", "qnodes", "time (ms)", "knps", "ebf", "move", "time to depth (ms)");
+
+    for (const string& algorithm : algorithms)
+        for (const string& heuristic : heuristics)
+            for (const CorpusPosition& corpus : CORPUS) {
+                int depth = plies > 0 ? plies : (algorithm == "minimax" ? 4 : 6);
+                BenchResult result = runSearch(corpus, algorithm, atoi(heuristic.c_str()), depth, quiescence, principalVariationSearch);
+
+                for (int r = 1; r < repeat; ++r) {
+                    BenchResult again = runSearch(corpus, algorithm, atoi(heuristic.c_str()), depth, quiescence, principalVariationSearch);
+
+                    if (again.ms < result.ms)
+                        result = again;
+                }
+
+                totalNodes += result.nodes;
+                totalMs += result.ms;
+                results.push_back(result);
+
+                string timeToDepth;
+
+                for (const Iteration& iteration : result.iterations) {
+                    char text[32];
+                    snprintf(text, sizeof(text), "%s%d:%.1f", timeToDepth.empty() ? "" : " ", iteration.depth, iteration.ms);
+                    timeToDepth += text;
+                }
+
+                fprintf(table, "%-9s %-9s %2d %5d %12llu %10llu %10.1f %10.0f %6.2f  %-6s %s\n", result.position.c_str(),
+                        result.algorithm.c_str(), result.heuristicIndex, result.plies, static_cast<unsigned long long>(result.nodes),
+                        static_cast<unsigned long long>(result.quiescenceNodes), result.ms, result.nps / 1000, result.branchingFactor, result.move.c_str(), timeToDepth.c_str());
+            }
+
+    fprintf(table, "total %llu nodes in %.1f ms, %.0f knps\n", static_cast<unsigned long long>(totalNodes), totalMs,
+            totalMs > 0 ? totalNodes / totalMs : 0);
+
+    if (jsonPath != nullptr) {
+        FILE* file = jsonToStdout ? stdout : fopen(jsonPath, "w");
+
+        if (file == nullptr) {
+            fprintf(stderr, "bench: cannot write %s\n", jsonPath);
+            return 1;
+        }
+
+        writeJson(file, results, totalNodes, totalMs);
+
+        if (!jsonToStdout)
+            fclose(file);
+    }
+
+    if (baselinePath != nullptr) {
+        int regressions = compareResults(baselinePath, results, tolerance, table);
+        return regressions == 0 ? 0 : 1;
+    }
+
+    return 0;
+}
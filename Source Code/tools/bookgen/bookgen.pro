@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Opening book generator, searches the first plies
+# from the start deeper than a game can afford
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = bookgen
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS += -std=c++14
+
+include(../../engine/engine.pri)
+
+SOURCES += \
+        main.cpp
@@ -0,0 +1,258 @@
+#include "ai.h"
+#include "openingbook.h"
+#include "notation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+/* Opening book generator, searches the positions of the first plies of a
+ * game from the start and writes the book the engine plays them from (see
+ * openingbook.h). Every move of a position is searched to the book's depth,
+ * so each one gets a score of its own like a search of several lines at
+ * once; the best moves within the margin of the best are kept, at most the
+ * width of them, and weighed by how close they come to it. The positions
+ * the kept moves lead to are searched in turn, ply by ply up to the plies
+ * of the book, those reached by several move orders only once. The book is
+ * then read back and every position checked against the moves kept for it.
+ * Run with --help for the options. */
+
+// Score of a move that leaves the other side without a move, as alpha-beta scores it
+const int BOOK_WIN_SCORE = 999999;
+// Weight of the best move is the margin + 1, the margin cannot make it overflow
+const int BOOK_MAX_MARGIN = 65534;
+
+// A position to be searched, by the plies from the start
+struct BookPosition {
+    Position position;
+    char player;
+    int ply;
+};
+
+// A position the book has moves for, for the check once the book is written
+struct KeptPosition {
+    Position position;
+    char player;
+    int moveCount;
+};
+
+static void printUsage() {
+    fprintf(stderr,
+            "usage: bookgen [options]\n"
+            "  -p, --plies <n>      plies from the start the book covers, default 6\n"
+            "  -d, --depth <plies>  plies searched behind each move, default 8\n"
+            "  -w, --width <n>      most moves kept per position, default 3\n"
+            "  -m, --margin <n>     moves kept scoring at most this much below the best, default 100\n"
+            "  -e, --heuristic <n>  0 = naive, 1 = counting, 2 = informed, default 2\n"
+            "  -j, --threads <n>    threads of each search, default 1\n"
+            "      --hash <MB>      transposition table size, default 64\n"
+            "  -o, --output <file>  the book, default book.bzbk\n");
+}
+
+static bool isOption(const char* arg, const char* shortName, const char* longName) {
+    return (shortName != nullptr && strcmp(arg, shortName) == 0) || strcmp(arg, longName) == 0;
+}
+
+/**
+ * @brief checkBook, reads the book back and looks up every position a move was kept for
+ * @return the positions whose moves the book does not give back
+ */
+
+static int checkBook(const string& path, const vector<KeptPosition>& kept) {
+    OpeningBook book;
+
+    if (!book.load(path)) {
+        fprintf(stderr, "bookgen: %s cannot be read back\n", path.c_str());
+        return static_cast<int>(kept.size());
+    }
+
+    int failures = 0;
+
+    for (const KeptPosition& entry : kept) {
+        const OpeningBookEntry* first = nullptr;
+        Move move;
+        OpeningBookEntry picked;
+        bool found = book.getEntries(entry.position, entry.player, first) == entry.moveCount
+                  && book.probe(entry.position, entry.player, 0, move, picked);
+
+        for (int i = 1; found && i < entry.moveCount; i++)
+            found = first[i - 1].weight >= first[i].weight;
+
+        if (!found) {
+            fprintf(stderr, "bookgen: %s %c is not in the book as written\n",
+                    positionName(entry.position).c_str(), entry.player);
+            failures++;
+        }
+    }
+
+    return failures;
+}
+
+int main(int argc, char* argv[]) {
+    int plies = 6;
+    int depth = 8;
+    int width = 3;
+    int margin = 100;
+    int heuristicIndex = 2;
+    int threadCount = 1;
+    int hashMB = 64;
+    string path = "book.bzbk";
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if (isOption(arg, "-h", "--help")) {
+            printUsage();
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            fprintf(stderr, "bookgen: %s needs a value\n", arg);
+            printUsage();
+            return 1;
+        }
+
+        const char* value = argv[++i];
+
+        if (isOption(arg, "-p", "--plies"))
+            plies = atoi(value);
+        else if (isOption(arg, "-d", "--depth"))
+            depth = atoi(value);
+        else if (isOption(arg, "-w", "--width"))
+            width = atoi(value);
+        else if (isOption(arg, "-m", "--margin"))
+            margin = atoi(value);
+        else if (isOption(arg, "-e", "--heuristic"))
+            heuristicIndex = atoi(value);
+        else if (isOption(arg, "-j", "--threads"))
+            threadCount = atoi(value);
+        else if (isOption(arg, nullptr, "--hash"))
+            hashMB = atoi(value);
+        else if (isOption(arg, "-o", "--output"))
+            path = value;
+        else {
+            fprintf(stderr, "bookgen: unknown option %s\n", arg);
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (plies < 1 || depth < 1 || depth >= MAX_PLY || width < 1 || margin < 0 || margin > BOOK_MAX_MARGIN
+            || heuristicIndex < 0 || heuristicIndex > 2 || threadCount < 1 || hashMB < 1) {
+        printUsage();
+        return 1;
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    Board board;
+    AIPlayer ai(&board);
+    ai.setTracing(false);
+    ai.setHashSize(hashMB);
+    ai.setThreadCount(threadCount);
+
+    vector<OpeningBookEntry> entries;
+    vector<KeptPosition> kept;
+    unordered_set<uint64_t> searched;
+    deque<BookPosition> queue;
+    uint64_t searches = 0;
+
+    queue.push_back({board.getPosition(), 'G', 0});
+
+    // ply by ply from the start, the positions of a ply are all queued before those of the next
+    while (!queue.empty()) {
+        BookPosition current = queue.front();
+        queue.pop_front();
+
+        uint64_t key = openingBookKey(current.position, current.player);
+
+        if (current.ply >= plies || !searched.insert(key).second)
+            continue;
+
+        char opponent = current.player == 'R' ? 'G' : 'R';
+        Move moves[MAX_MOVES];
+        int moveCount = current.position.generateMoves(current.player, moves);
+        vector<pair<int, int>> scored; //Score for the side to move and index of each move
+
+        for (int i = 0; i < moveCount; i++) {
+            Position child = current.position;
+            child.applyMove(moves[i]);
+
+            Move replies[MAX_MOVES];
+            int score;
+
+            // the search of the reply scores the move, a move that leaves no reply wins
+            if (child.generateMoves(opponent, replies) == 0)
+                score = current.player == 'G' ? BOOK_WIN_SCORE : -BOOK_WIN_SCORE;
+            else {
+                board.setPosition(child);
+                ai.getNextMoveFromAI(depth, opponent, false, heuristicIndex);
+                score = ai.getScore();
+                searches++;
+            }
+
+            scored.push_back(make_pair(current.player == 'G' ? score : -score, i));
+        }
+
+        // best first, moves of equal score in move order
+        stable_sort(scored.begin(), scored.end(), [](const pair<int, int>& a, const pair<int, int>& b) {
+            return a.first > b.first;
+        });
+
+        int keptMoves = 0;
+
+        for (const pair<int, int>& move : scored) {
+            int behind = scored.front().first - move.first;
+
+            if (keptMoves == width || behind > margin)
+                break;
+
+            OpeningBookEntry entry;
+            entry.key = key;
+            entry.score = current.player == 'G' ? move.first : -move.first;
+            entry.weight = static_cast<uint16_t>(margin + 1 - behind);
+            entry.from = static_cast<uint8_t>(moves[move.second].from);
+            entry.to = static_cast<uint8_t>(moves[move.second].to);
+            entries.push_back(entry);
+            keptMoves++;
+
+            Position child = current.position;
+            child.applyMove(moves[move.second]);
+            queue.push_back({child, opponent, current.ply + 1});
+        }
+
+        if (keptMoves > 0)
+            kept.push_back({current.position, current.player, keptMoves});
+
+        fprintf(stderr, "\rply %d: %zu positions, %zu moves, %llu searches   ", current.ply, kept.size(), entries.size(),
+                static_cast<unsigned long long>(searches));
+    }
+
+    fprintf(stderr, "\n");
+
+    OpeningBookHeader header;
+    header.plies = plies;
+    header.depth = depth;
+    header.heuristicIndex = heuristicIndex;
+
+    if (!writeOpeningBook(path, header, entries)) {
+        fprintf(stderr, "bookgen: cannot write %s\n", path.c_str());
+        return 1;
+    }
+
+    int failures = checkBook(path, kept);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("%zu positions, %zu moves, %zu bytes\n", kept.size(), entries.size(),
+           sizeof(OpeningBookHeader) + entries.size() * sizeof(OpeningBookEntry));
+    printf("%s, %.1f s\n", failures == 0 ? "book checks out" : "book does NOT check out", seconds);
+    return failures == 0 ? 0 : 1;
+}
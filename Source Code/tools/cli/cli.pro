@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# Command-line engine, searches a position given
+# on the command line and prints the best move
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = bonzee
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS += -std=c++14
+
+include(../../engine/engine.pri)
+
+SOURCES += \
+        main.cpp
+
+DISTFILES += \
+        perft.txt
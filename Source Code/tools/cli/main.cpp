@@ -0,0 +1,461 @@
+#include "ai.h"
+#include "mcts.h"
+#include "notation.h"
+#include "protocol.h"
+#include "perft.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+/* Command-line engine, searches one position and prints the chosen move,
+ * its score (green minus red, in units of the heuristic), the plies searched,
+ * the nodes and the milliseconds taken; with -a mcts the playouts and their
+ * rate as well, with --tablebase the positions the endgame tables held,
+ * with --book whether the move came from the opening book.
+ * Run with --help for the options.
+ * With --protocol it instead reads the commands of protocol.h from stdin,
+ * with --perft it counts the move tree of the position instead of searching
+ * it, and --perft-check compares the counts of a reference file. With
+ * --eval-check it verifies the state Position keeps up to date move by move,
+ * with --alloc-check that a search allocates nothing once it is set up. */
+
+// Heap allocations of the process, every operator new of the
+// program comes through here so --alloc-check can count them
+static std::atomic<uint64_t> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = malloc(size == 0 ? 1 : size))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+static void printUsage() {
+    fprintf(stderr,
+            "usage: bonzee [options]\n"
+            "       bonzee --protocol\n"
+            "       bonzee --perft <plies> [--divide] [options]\n"
+            "       bonzee --perft-check <file> [-j <n>]\n"
+            "       bonzee --eval-check <plies> [options]\n"
+            "       bonzee --alloc-check [options]\n"
+            "  -i, --protocol          read engine commands from stdin, see protocol.h\n"
+            "  -p, --position <rows>   rows A to E separated by '/', R, G or X per tile, default start\n"
+            "  -s, --side <R|G>        side to move, default G\n"
+            "  -d, --depth <plies>     deepest search, default 5\n"
+            "  -t, --time <ms>         time per move, 0 = no limit, default 0\n"
+            "  -a, --algorithm <name>  minimax, alphabeta or mcts, default alphabeta\n"
+            "  -e, --heuristic <n>     0 = naive, 1 = counting, 2 = informed, default 2\n"
+            "  -j, --threads <n>       threads of an alpha-beta or mcts search, default 1\n"
+            "      --hash <MB>         transposition table size, default 16\n"
+            "  -q, --quiescence <0|1>  play out captures past the leaves of alpha-beta, default 1\n"
+            "      --pvs <0|1>         null window and aspiration searches in alpha-beta, default 1\n"
+            "      --playouts <n>      playouts of an mcts search, 0 = until the time is up, default 0,\n"
+            "                          20000 when there is no time limit either\n"
+            "      --parallel <mode>   tree: the mcts threads share one tree, root: one tree each, default tree\n"
+            "      --stats <file>      append the statistics of the search to file as a line of JSON\n"
+            "      --tablebase <dir>   endgame tables written by tbgen, probed by alpha-beta and\n"
+            "                          for the move itself\n"
+            "      --book <file>       opening book written by bookgen, a position it holds\n"
+            "                          is played from it without a search\n"
+            "      --perft <plies>     count the leaves of the move tree instead of searching\n"
+            "      --divide            with --perft, the leaves below each move of the side to move\n"
+            "      --perft-check <file> count the positions of a reference file, lines of\n"
+            "                          \"<rows|start> <R|G> <plies> <leaves>\", exit 1 on a mismatch\n"
+            "      --eval-check <plies> compare the hash and evaluation sums kept move by move with\n"
+            "                          the values built from scratch, exit 1 on a mismatch\n"
+            "      --alloc-check       search the position a few times with each algorithm, with and without\n"
+            "                          the tree, exit 1 if the last search allocates\n"
+            "  -j applies to perft as well, the moves of the side to move are split between threads\n");
+}
+
+static bool isOption(const char* arg, const char* shortName, const char* longName) {
+    return (shortName != nullptr && strcmp(arg, shortName) == 0) || strcmp(arg, longName) == 0;
+}
+
+static uint64_t countLeaves(const std::vector<PerftDivide>& divide) {
+    uint64_t nodes = 0;
+
+    for (const PerftDivide& entry : divide)
+        nodes += entry.nodes;
+
+    return nodes;
+}
+
+/**
+ * @brief runPerft, prints the leaf count of the position and the counting speed
+ * @param divide, also prints the count below each root move
+ */
+
+static void runPerft(const Position& position, char side, int plies, bool divide, int threads) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    std::vector<PerftDivide> counts = perftDivide(position, side, plies, threads);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    uint64_t nodes = countLeaves(counts);
+
+    if (divide) {
+        for (const PerftDivide& entry : counts)
+            printf("%s %llu\n", moveName(entry.move).c_str(), static_cast<unsigned long long>(entry.nodes));
+
+        printf("moves %zu\n", counts.size());
+    }
+
+    printf("nodes %llu\n", static_cast<unsigned long long>(nodes));
+    printf("time %.0f\n", elapsed * 1000);
+    printf("nps %.0f\n", elapsed > 0 ? nodes / elapsed : 0);
+}
+
+/**
+ * @brief checkPerft, counts every position of a reference file and prints ok or FAIL
+ *        for each, blank lines and lines starting with # are skipped
+ * @return the process exit code, 0 when all counts match
+ */
+
+static int checkPerft(const char* path, int threads) {
+    std::ifstream file(path);
+
+    if (!file) {
+        fprintf(stderr, "bonzee: cannot read %s\n", path);
+        return 1;
+    }
+
+    std::string line;
+    int failures = 0;
+    int checked = 0;
+
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string rows;
+        std::string side;
+        int plies = 0;
+        unsigned long long expected = 0;
+
+        if (!(stream >> rows) || rows[0] == '#')
+            continue;
+
+        Position position;
+
+        if (!(stream >> side >> plies >> expected) || plies < 1 || !parsePosition(rows, position)) {
+            fprintf(stderr, "bonzee: invalid perft line %s\n", line.c_str());
+            return 1;
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        uint64_t nodes = countLeaves(perftDivide(position, side == "R" ? 'R' : 'G', plies, threads));
+        long long elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+        bool match = nodes == expected;
+        failures += !match;
+        checked++;
+
+        printf("%-4s %s %s %d: %llu, expected %llu, %lld ms\n", match ? "ok" : "FAIL", rows.c_str(), side.c_str(), plies,
+               static_cast<unsigned long long>(nodes), expected, elapsed);
+    }
+
+    printf("%d of %d counts match\n", checked - failures, checked);
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief checkAllocations, searches the position three times per algorithm and counts the
+ *        allocations of the last search, the first ones set up the tables and buffers
+ * @param plies, depth of the alpha-beta searches, minimax searches 2 plies less
+ * @return the process exit code, 0 when no search allocated
+ */
+
+static int checkAllocations(const Position& position, char side, int plies, int heuristicIndex, int threads) {
+    Board board(position);
+    int failures = 0;
+
+    for (int run = 0; run < 4; run++) {
+        bool isMinimax = run >= 2;
+        bool tracing = run % 2 == 1;
+        int depth = isMinimax ? max(1, plies - 2) : plies;
+
+        AIPlayer ai(&board);
+        ai.setThreadCount(isMinimax ? 1 : threads);
+        ai.setTracing(tracing);
+
+        // the tree of the last move is held while the next is searched, as the
+        // window displays it, the trees stop growing by the third search
+        shared_ptr<const SearchTrace> displayed;
+        uint64_t count = 0;
+
+        for (int search = 0; search < 3; search++) {
+            uint64_t before = allocations.load();
+            ai.getNextMoveFromAI(depth + 1, side, isMinimax, heuristicIndex);
+            count = allocations.load() - before;
+            displayed = ai.getSearchTrace();
+        }
+
+        failures += count != 0;
+        printf("%-4s %s, %d plies, tree %s: %llu allocations\n", count == 0 ? "ok" : "FAIL",
+               isMinimax ? "minimax" : "alphabeta", depth, tracing ? "on" : "off", static_cast<unsigned long long>(count));
+    }
+
+    MCTSPlayer mcts(&board);
+    mcts.setThreadCount(threads);
+    mcts.setPlayoutLimit(MCTS_DEFAULT_PLAYOUTS / 10);
+    mcts.getNextMoveFromMCTS(side);
+
+    uint64_t before = allocations.load();
+    mcts.getNextMoveFromMCTS(side);
+    uint64_t count = allocations.load() - before;
+
+    failures += count != 0;
+    printf("%-4s mcts, %llu playouts: %llu allocations\n", count == 0 ? "ok" : "FAIL",
+           static_cast<unsigned long long>(MCTS_DEFAULT_PLAYOUTS / 10), static_cast<unsigned long long>(count));
+
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief appendStats, appends the statistics of the search to a log, one search per line
+ * @return false when the log cannot be written
+ */
+
+static bool appendStats(const char* path, const SearchStats& stats) {
+    ofstream log(path, ios::app);
+    log << statsLine(stats) << '\n';
+
+    if (!log) {
+        fprintf(stderr, "bonzee: cannot write %s\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    Position position;
+    char side = 'G';
+    int plies = 5;
+    int timeLimit = 0;
+    bool isMinimax = false;
+    bool isMonteCarlo = false;
+    int heuristicIndex = 2;
+    int threads = 1;
+    int hashSize = 16;
+    bool quiescence = true;
+    bool principalVariationSearch = true;
+    unsigned long long playouts = 0;
+    int parallelism = MCTS_TREE_PARALLEL;
+    const char* statsFile = nullptr;
+    const char* tablebaseDirectory = nullptr;
+    const char* bookFile = nullptr;
+    int perftPlies = 0;
+    bool divide = false;
+    const char* perftFile = nullptr;
+    int checkPlies = 0;
+    bool allocationCheck = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if (isOption(arg, "-h", "--help")) {
+            printUsage();
+            return 0;
+        }
+
+        if (isOption(arg, "-i", "--protocol")) {
+            EngineProtocol protocol(std::cout);
+            std::string line;
+
+            while (std::getline(std::cin, line) && protocol.handleLine(line)) {
+            }
+
+            return 0;
+        }
+
+        if (isOption(arg, nullptr, "--alloc-check")) {
+            allocationCheck = true;
+            continue;
+        }
+
+        if (isOption(arg, nullptr, "--divide")) {
+            divide = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            fprintf(stderr, "bonzee: %s needs a value\n", arg);
+            printUsage();
+            return 1;
+        }
+
+        const char* value = argv[++i];
+
+        if (isOption(arg, "-p", "--position")) {
+            if (!parsePosition(value, position)) {
+                fprintf(stderr, "bonzee: invalid position %s\n", value);
+                return 1;
+            }
+        }
+        else if (isOption(arg, "-s", "--side"))
+            side = (value[0] == 'r' || value[0] == 'R') ? 'R' : 'G';
+        else if (isOption(arg, "-d", "--depth"))
+            plies = atoi(value);
+        else if (isOption(arg, "-t", "--time"))
+            timeLimit = atoi(value);
+        else if (isOption(arg, "-a", "--algorithm"))
+        {
+            isMinimax = strcmp(value, "minimax") == 0;
+            isMonteCarlo = strcmp(value, "mcts") == 0;
+        }
+        else if (isOption(arg, "-e", "--heuristic"))
+            heuristicIndex = atoi(value);
+        else if (isOption(arg, "-j", "--threads"))
+            threads = atoi(value);
+        else if (isOption(arg, nullptr, "--hash"))
+            hashSize = atoi(value);
+        else if (isOption(arg, "-q", "--quiescence"))
+            quiescence = atoi(value) != 0;
+        else if (isOption(arg, nullptr, "--pvs"))
+            principalVariationSearch = atoi(value) != 0;
+        else if (isOption(arg, nullptr, "--playouts"))
+            playouts = strtoull(value, nullptr, 10);
+        else if (isOption(arg, nullptr, "--parallel"))
+            parallelism = strcmp(value, "root") == 0 ? MCTS_ROOT_PARALLEL : MCTS_TREE_PARALLEL;
+        else if (isOption(arg, nullptr, "--stats"))
+            statsFile = value;
+        else if (isOption(arg, nullptr, "--tablebase"))
+            tablebaseDirectory = value;
+        else if (isOption(arg, nullptr, "--book"))
+            bookFile = value;
+        else if (isOption(arg, nullptr, "--perft"))
+            perftPlies = atoi(value);
+        else if (isOption(arg, nullptr, "--perft-check"))
+            perftFile = value;
+        else if (isOption(arg, nullptr, "--eval-check"))
+            checkPlies = atoi(value);
+        else {
+            fprintf(stderr, "bonzee: unknown option %s\n", arg);
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (plies < 1 || plies >= MAX_PLY || heuristicIndex < 0 || heuristicIndex > 2 || threads < 1 || hashSize < 1) {
+        fprintf(stderr, "bonzee: search limits out of range\n");
+        return 1;
+    }
+
+    if (perftFile != nullptr)
+        return checkPerft(perftFile, threads);
+
+    if (checkPlies > 0) {
+        uint64_t checked = 0;
+        uint64_t mismatches = checkIncremental(position, side, checkPlies, checked);
+
+        printf("positions %llu\n", static_cast<unsigned long long>(checked));
+        printf("mismatches %llu\n", static_cast<unsigned long long>(mismatches));
+        return mismatches == 0 ? 0 : 1;
+    }
+
+    if (perftPlies > 0) {
+        runPerft(position, side, perftPlies, divide, threads);
+        return 0;
+    }
+
+    if (allocationCheck)
+        return checkAllocations(position, side, plies, heuristicIndex, threads);
+
+    Move moves[MAX_MOVES];
+
+    if (position.generateMoves(side, moves) == 0) {
+        printf("bestmove none\n");
+        return 0;
+    }
+
+    Board board(position);
+
+    if (isMonteCarlo) {
+        MCTSPlayer mcts(&board);
+        mcts.setThreadCount(threads);
+        mcts.setParallelism(parallelism);
+        mcts.setPlayoutLimit(playouts);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        Move move = mcts.getNextMoveFromMCTS(side, timeLimit);
+        long long elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+        printf("bestmove %s\n", moveName(move).c_str());
+        printf("score %d\n", mcts.getScore());
+        printf("depth %d\n", mcts.getCompletedDepth());
+        printf("nodes %llu\n", static_cast<unsigned long long>(mcts.getNodeCount()));
+        printf("playouts %llu\n", static_cast<unsigned long long>(mcts.getPlayoutCount()));
+        printf("pps %.0f\n", mcts.getPlayoutsPerSecond());
+        printf("time %lld\n", elapsed);
+
+        return statsFile == nullptr || appendStats(statsFile, mcts.getSearchStats()) ? 0 : 1;
+    }
+
+    AIPlayer ai(&board);
+    ai.setHashSize(hashSize);
+    ai.setThreadCount(threads);
+    ai.setTracing(false);
+    ai.setQuiescence(quiescence);
+    ai.setPrincipalVariationSearch(principalVariationSearch);
+
+    if (tablebaseDirectory != nullptr) {
+        shared_ptr<Tablebase> tablebase = make_shared<Tablebase>();
+
+        if (tablebase->load(tablebaseDirectory) == 0) {
+            fprintf(stderr, "bonzee: no tables in %s\n", tablebaseDirectory);
+            return 1;
+        }
+
+        ai.setTablebase(tablebase);
+    }
+
+    if (bookFile != nullptr) {
+        shared_ptr<OpeningBook> book = make_shared<OpeningBook>();
+
+        if (!book->load(bookFile)) {
+            fprintf(stderr, "bonzee: %s is not an opening book\n", bookFile);
+            return 1;
+        }
+
+        ai.setOpeningBook(book);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Move move = ai.getNextMoveFromAI(plies + 1, side, isMinimax, heuristicIndex, timeLimit);
+    long long elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    printf("bestmove %s\n", moveName(move).c_str());
+    printf("score %d\n", ai.getScore());
+    printf("depth %d\n", ai.getCompletedDepth());
+    printf("nodes %llu\n", static_cast<unsigned long long>(ai.getNodeCount()));
+    printf("qnodes %llu\n", static_cast<unsigned long long>(ai.getQuiescenceNodeCount()));
+    printf("researches %llu\n", static_cast<unsigned long long>(ai.getResearchCount()));
+    printf("pv %s\n", lineName(ai.getPrincipalVariation()).c_str());
+
+    if (tablebaseDirectory != nullptr)
+        printf("tbhits %llu\n", static_cast<unsigned long long>(ai.getTablebaseHits()));
+
+    if (bookFile != nullptr)
+        printf("book %s\n", ai.getSearchStats().algorithm == "book" ? "hit" : "miss");
+
+    printf("time %lld\n", elapsed);
+
+    return statsFile == nullptr || appendStats(statsFile, ai.getSearchStats()) ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#include "ai.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+/* Lazy SMP scaling benchmark
+ * Each position is searched with alpha-beta to a fixed depth, without a time
+ * limit, once per thread count. The speedup is the time to reach that depth
+ * with one thread divided by the time with N threads.
+ *
+ * usage: smpbench [plies] [heuristic]
+ *  plies     : search depth, default 7
+ *  heuristic : 0 = naive, 1 = counting, 2 = informed, default 2 */
+
+struct BenchPosition {
+    const char* name;
+    const char* rows[BOARD_HEIGHT];
+    char player;
+};
+
+static const BenchPosition POSITIONS[] = {
+    {"start", {"RRRRRRRRR", "RRRRRRRRR", "GGGGXRRRR", "GGGGGGGGG", "GGGGGGGGG"}, 'G'},
+    {"midgame", {"RRXRRXRRR", "RXRRGRXRR", "GGXGXRRXR", "GXGGRGXGG", "GGXGGGGXG"}, 'G'},
+    {"open", {"RXXRXXRXR", "XRXXGXXRX", "GXXXXRXXR", "XXGXGXXGX", "GXXGXXGXG"}, 'R'}
+};
+
+static const int THREAD_COUNTS[] = {1, 2, 4, 8};
+
+static Position makePosition(const BenchPosition& bench) {
+    Position position(0, 0);
+
+    for (int y = 0; y < BOARD_HEIGHT; ++y)
+        for (int x = 0; x < BOARD_WIDTH; ++x)
+            position.setValueAt(x, y, bench.rows[y][x]);
+
+    return position;
+}
+
+int main(int argc, char *argv[])
+{
+    int plies = argc > 1 ? atoi(argv[1]) : 7;
+    int heuristicIndex = argc > 2 ? atoi(argv[2]) : 2;
+
+    printf("%-8s %7s %10s %12s %10s %8s  %s\n", "position", "threads", "time (ms)", "nodes", "knps", "speedup", "move");
+
+    for (const BenchPosition& bench : POSITIONS) {
+        double singleThreadTime = 0;
+
+        for (int threads : THREAD_COUNTS) {
+            Board board(makePosition(bench));
+            AIPlayer ai(&board);
+            ai.setThreadCount(threads);
+            ai.setTracing(false);
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            Move move = ai.getNextMoveFromAI(plies + 1, bench.player, false, heuristicIndex);
+            double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+            if (threads == 1)
+                singleThreadTime = elapsed;
+
+            printf("%-8s %7d %10.1f %12llu %10.0f %7.2fx  %d,%d -> %d,%d\n", bench.name, threads, elapsed,
+                   static_cast<unsigned long long>(ai.getNodeCount()), ai.getNodeCount() / elapsed,
+                   singleThreadTime / elapsed, Position::getX(move.from), Position::getY(move.from),
+                   Position::getX(move.to), Position::getY(move.to));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Lazy SMP scaling benchmark, searches fixed positions
+# to a fixed depth with 1, 2, 4 and 8 threads
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = smpbench
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS += -std=c++14
+
+include(../../engine/engine.pri)
+
+SOURCES += \
+        main.cpp
@@ -0,0 +1,465 @@
+#include "tablebase.h"
+#include "movetables.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/* Tablebase generator, solves every position with up to k tokens per side
+ * by retrograde analysis and writes the tables the engine probes (see
+ * tablebase.h). The tables are solved from the fewest tokens up, a capture
+ * always leads to a table solved before; a quiet move leads to the table of
+ * the same material with the sides swapped, so those two are solved
+ * together.
+ *
+ * Each position first counts its quiet moves and looks up its captures: a
+ * side without a move has lost, a capture into a lost position wins. Then,
+ * one distance at a time, every position decided at that distance is taken
+ * back a quiet move: a predecessor of a lost position wins one ply later,
+ * and a predecessor of a won position has one quiet move less that does not
+ * lose, with none left it has lost. Positions still open at the end are
+ * draws. Both passes split the positions between threads.
+ * Run with --help for the options. */
+
+// Positions a thread takes at once
+const uint64_t CHUNK_SIZE = 1 << 14;
+// Positions of each table read back from its file and checked against its moves
+const uint64_t CHECKED_POSITIONS = 20000;
+
+// Bit of a position's move count set when one of its captures does not lose
+const uint8_t NOT_LOST = 0x80;
+
+// A table being solved, the positions after its quiet moves are in replies
+struct SolveTable {
+    int moverTokens;
+    int otherTokens;
+    uint64_t size;
+    unique_ptr<atomic<uint8_t>[]> values; //Entries as in tablebase.h, 0 while open
+    unique_ptr<atomic<uint8_t>[]> counts; //Quiet moves not known to lose yet, and NOT_LOST
+    SolveTable* replies;
+};
+
+// Entries of the tables solved so far, by tokens of the side to move and of the other side
+static vector<uint8_t> solved[TABLEBASE_MAX_TOKENS + 1][TABLEBASE_MAX_TOKENS + 1];
+
+static void printUsage() {
+    fprintf(stderr,
+            "usage: tbgen [options]\n"
+            "  -k, --tokens <n>     most tokens per side, 1 to %d, default 2\n"
+            "  -j, --threads <n>    threads, default one per core\n"
+            "  -o, --output <dir>   directory the tables are written to, default the current one\n",
+            TABLEBASE_MAX_TOKENS);
+}
+
+static bool isOption(const char* arg, const char* shortName, const char* longName) {
+    return (shortName != nullptr && strcmp(arg, shortName) == 0) || strcmp(arg, longName) == 0;
+}
+
+/**
+ * @brief forEachMove, calls visit(from, to, captured) for every move of the side to move,
+ *        the moves of Position::generateMoves
+ * @param mover, tokens of the side to move
+ * @param other, tokens of the other side
+ */
+
+template<class Visit>
+static void forEachMove(uint64_t mover, uint64_t other, Visit visit) {
+    uint64_t emptyTiles = BOARD_MASK & ~(mover | other);
+    uint64_t tokens = mover;
+
+    while (tokens) {
+        int from = firstSquare(tokens);
+        tokens &= tokens - 1;
+
+        for (int d = 0; d < DIRECTION_COUNT; ++d) {
+            int to = MOVE_TABLES.step[from][d];
+
+            if (to >= 0 && (emptyTiles & squareBit(to)))
+                visit(from, to, getCaptures(from, to, d, other));
+        }
+    }
+}
+
+/**
+ * @brief captureReply, entry of the position after a capture, for the side that lost tokens
+ * @param remaining, its tokens left
+ * @param capturer, tokens of the side that captured, after its move
+ */
+
+static uint8_t captureReply(uint64_t remaining, uint64_t capturer) {
+    // without tokens the side has lost, 0 plies from the end
+    if (remaining == 0)
+        return 1;
+
+    return solved[popCount(remaining)][popCount(capturer)][tablebaseIndex(remaining, capturer)];
+}
+
+/**
+ * @brief lossValue, entry of a lost position, one ply more than the longest win among its replies
+ * @param table, the table of the position
+ */
+
+static uint8_t lossValue(const SolveTable& table, uint64_t mover, uint64_t other) {
+    int longest = 0;
+
+    forEachMove(mover, other, [&](int from, int to, uint64_t captured) {
+        uint64_t moved = mover ^ squareBit(from) ^ squareBit(to);
+        int reply = captured ? captureReply(other & ~captured, moved)
+                             : table.replies->values[tablebaseIndex(other, moved)].load(memory_order_relaxed);
+        longest = max(longest, reply);
+    });
+
+    // the win one ply before the loss has to fit in an entry as well, an entry
+    // of TABLEBASE_MAX_DISTANCE + 2 would wrap around to a draw
+    if (longest + 1 > TABLEBASE_MAX_DISTANCE) {
+        fprintf(stderr, "\ntbgen: a game of %dv%d is longer than %d plies\n", table.moverTokens,
+                table.otherTokens, TABLEBASE_MAX_DISTANCE - 1);
+        exit(1);
+    }
+
+    return static_cast<uint8_t>(longest + 1);
+}
+
+/**
+ * @brief forEachPosition, splits the positions of the tables between threads and shows the progress
+ * @param work, called with a table and a range of its positions
+ * @param label, printed before the percentage done
+ */
+
+static void forEachPosition(const vector<SolveTable*>& tables, int threadCount, const string& label,
+                            const function<void(SolveTable&, uint64_t, uint64_t)>& work) {
+    vector<uint64_t> firstChunk;
+    uint64_t chunkCount = 0;
+
+    for (SolveTable* table : tables) {
+        firstChunk.push_back(chunkCount);
+        chunkCount += (table->size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    }
+
+    atomic<uint64_t> nextChunk(0);
+    atomic<uint64_t> chunksDone(0);
+    vector<thread> threads;
+
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back([&] {
+            uint64_t chunk;
+
+            while ((chunk = nextChunk.fetch_add(1)) < chunkCount) {
+                size_t t = tables.size() - 1;
+
+                while (firstChunk[t] > chunk)
+                    t--;
+
+                SolveTable& table = *tables[t];
+                uint64_t begin = (chunk - firstChunk[t]) * CHUNK_SIZE;
+
+                work(table, begin, min(begin + CHUNK_SIZE, table.size));
+                chunksDone.fetch_add(1);
+            }
+        });
+    }
+
+    // most passes take a fraction of a second, so the threads are polled
+    // often and the progress only printed now and then
+    chrono::steady_clock::time_point printed;
+
+    while (chunksDone.load() < chunkCount) {
+        if (chrono::steady_clock::now() - printed >= chrono::milliseconds(250)) {
+            fprintf(stderr, "\r%s %3d%%", label.c_str(), static_cast<int>(100 * chunksDone.load() / chunkCount));
+            fflush(stderr);
+            printed = chrono::steady_clock::now();
+        }
+
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+
+    for (thread& worker : threads)
+        worker.join();
+
+    fprintf(stderr, "\r%s 100%%", label.c_str());
+    fflush(stderr);
+}
+
+/**
+ * @brief solveTables, solves a material and the one with the sides swapped, the same table when equal
+ * @param tables, one or two tables, each the replies table of the other
+ * @return the longest distance of a decided position, in plies
+ */
+
+static int solveTables(const vector<SolveTable*>& tables, int threadCount, const string& name) {
+    atomic<int> highest(0);
+
+    auto raiseHighest = [&](int value) {
+        int current = highest.load(memory_order_relaxed);
+
+        while (value > current && !highest.compare_exchange_weak(current, value, memory_order_relaxed)) {
+        }
+    };
+
+    // moves and captures of every position
+    forEachPosition(tables, threadCount, name + ": moves", [&](SolveTable& table, uint64_t begin, uint64_t end) {
+        for (uint64_t index = begin; index < end; index++) {
+            uint64_t mover, other;
+            tablebasePosition(index, table.moverTokens, table.otherTokens, mover, other);
+
+            int moveCount = 0;
+            int quietMoves = 0;
+            bool notLost = false;
+            uint8_t win = 0;
+
+            forEachMove(mover, other, [&](int from, int to, uint64_t captured) {
+                moveCount++;
+
+                if (captured == 0) {
+                    quietMoves++;
+                    return;
+                }
+
+                uint8_t reply = captureReply(other & ~captured, mover ^ squareBit(from) ^ squareBit(to));
+
+                // a reply with an even distance is lost for the other side
+                if (reply != 0 && (reply - 1) % 2 == 0)
+                    win = win == 0 ? reply + 1 : min<uint8_t>(win, reply + 1);
+
+                notLost = notLost || reply == 0 || (reply - 1) % 2 == 0;
+            });
+
+            uint8_t value = win;
+
+            if (moveCount == 0)
+                value = 1;
+            else if (quietMoves == 0 && !notLost)
+                value = lossValue(table, mover, other);
+
+            table.values[index].store(value, memory_order_relaxed);
+            table.counts[index].store(static_cast<uint8_t>(quietMoves | (notLost ? NOT_LOST : 0)), memory_order_relaxed);
+            raiseHighest(value);
+        }
+    });
+
+    // every distance in turn, the positions decided at it decide their predecessors
+    for (int value = 1; value <= highest.load(); value++) {
+        string label = name + ": " + to_string(value - 1) + " plies";
+        bool lost = (value - 1) % 2 == 0;
+
+        forEachPosition(tables, threadCount, label, [&](SolveTable& table, uint64_t begin, uint64_t end) {
+            SolveTable& previous = *table.replies;
+
+            for (uint64_t index = begin; index < end; index++) {
+                if (table.values[index].load(memory_order_relaxed) != value)
+                    continue;
+
+                uint64_t mover, other;
+                tablebasePosition(index, table.moverTokens, table.otherTokens, mover, other);
+                uint64_t emptyTiles = BOARD_MASK & ~(mover | other);
+
+                // the other side's quiet moves into the position, taken back
+                for (uint64_t tokens = other; tokens; tokens &= tokens - 1) {
+                    int to = firstSquare(tokens);
+
+                    for (int d = 0; d < DIRECTION_COUNT; ++d) {
+                        int from = MOVE_TABLES.step[to][d];
+
+                        if (from < 0 || (emptyTiles & squareBit(from)) == 0
+                                || getCaptures(from, to, oppositeDirection(d), mover) != 0)
+                            continue;
+
+                        uint64_t before = other ^ squareBit(to) ^ squareBit(from);
+                        uint64_t predecessor = tablebaseIndex(before, mover);
+
+                        if (lost) {
+                            uint8_t current = previous.values[predecessor].load(memory_order_relaxed);
+                            uint8_t win = static_cast<uint8_t>(value + 1);
+
+                            while ((current == 0 || current > win)
+                                   && !previous.values[predecessor].compare_exchange_weak(current, win, memory_order_relaxed)) {
+                            }
+
+                            raiseHighest(win);
+                        }
+                        else if (previous.counts[predecessor].fetch_sub(1, memory_order_relaxed) == 1) {
+                            uint8_t loss = lossValue(previous, before, mover);
+                            previous.values[predecessor].store(loss, memory_order_relaxed);
+                            raiseHighest(loss);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    fprintf(stderr, "\r%-40s\r", "");
+    return highest.load() - 1;
+}
+
+/**
+ * @brief checkTables, reads positions of every table back through the engine's probe and
+ *        checks them against their file name material and against the results of their moves
+ * @return the number of positions that do not check out
+ */
+
+static uint64_t checkTables(const string& directory, int maxTokens) {
+    Tablebase tablebase;
+    uint64_t failures = 0;
+
+    if (tablebase.load(directory) == 0 || tablebase.getMaxTokens() < maxTokens) {
+        fprintf(stderr, "tbgen: cannot load the tables from %s\n", directory.c_str());
+        return 1;
+    }
+
+    for (int moverTokens = 1; moverTokens <= maxTokens; moverTokens++) {
+        for (int otherTokens = 1; otherTokens <= maxTokens; otherTokens++) {
+            const vector<uint8_t>& entries = solved[moverTokens][otherTokens];
+            uint64_t size = entries.size();
+            uint64_t samples = min(size, CHECKED_POSITIONS);
+
+            for (uint64_t i = 0; i < samples; i++) {
+                uint64_t index = i * size / samples;
+                uint64_t mover, other;
+                tablebasePosition(index, moverTokens, otherTokens, mover, other);
+
+                Position position(other, mover);
+                TablebaseEntry entry, best;
+                Move move;
+                bool found = tablebase.probe(position, 'G', entry);
+                TablebaseEntry expected = decodeTablebaseEntry(entries[index]);
+
+                if (!found || entry.result != expected.result || entry.distance != expected.distance
+                        || tablebaseIndex(mover, other) != index) {
+                    failures++;
+                    continue;
+                }
+
+                // the entry is the best result among the moves, a side without one has lost
+                if (tablebase.probeRoot(position, 'G', move, best)) {
+                    if (best.result != entry.result || best.distance != entry.distance)
+                        failures++;
+                }
+                else if (entry.result != -1 || entry.distance != 0)
+                    failures++;
+            }
+        }
+    }
+
+    return failures;
+}
+
+int main(int argc, char* argv[]) {
+    int maxTokens = 2;
+    int threadCount = max(1, static_cast<int>(thread::hardware_concurrency()));
+    string directory = ".";
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if (isOption(arg, "-h", "--help")) {
+            printUsage();
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            fprintf(stderr, "tbgen: %s needs a value\n", arg);
+            printUsage();
+            return 1;
+        }
+
+        const char* value = argv[++i];
+
+        if (isOption(arg, "-k", "--tokens"))
+            maxTokens = atoi(value);
+        else if (isOption(arg, "-j", "--threads"))
+            threadCount = atoi(value);
+        else if (isOption(arg, "-o", "--output"))
+            directory = value;
+        else {
+            fprintf(stderr, "tbgen: unknown option %s\n", arg);
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (maxTokens < 1 || maxTokens > TABLEBASE_MAX_TOKENS || threadCount < 1) {
+        printUsage();
+        return 1;
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    // by total tokens, so the tables a capture leads to are always solved
+    for (int total = 2; total <= 2 * maxTokens; total++) {
+        for (int fewer = 1; fewer <= maxTokens; fewer++) {
+            int more = total - fewer;
+
+            if (more < fewer || more > maxTokens)
+                continue;
+
+            vector<unique_ptr<SolveTable>> owned;
+            vector<SolveTable*> tables;
+
+            for (int side = 0; side < (fewer == more ? 1 : 2); side++) {
+                SolveTable* table = new SolveTable();
+                table->moverTokens = side == 0 ? fewer : more;
+                table->otherTokens = side == 0 ? more : fewer;
+                table->size = tablebaseSize(table->moverTokens, table->otherTokens);
+                table->values.reset(new atomic<uint8_t>[table->size]());
+                table->counts.reset(new atomic<uint8_t>[table->size]());
+                owned.emplace_back(table);
+                tables.push_back(table);
+            }
+
+            tables.front()->replies = tables.back();
+            tables.back()->replies = tables.front();
+
+            string name = to_string(fewer) + "v" + to_string(more);
+
+            if (fewer != more)
+                name += " and " + to_string(more) + "v" + to_string(fewer);
+
+            int longest = solveTables(tables, threadCount, name);
+
+            for (SolveTable* table : tables) {
+                vector<uint8_t>& entries = solved[table->moverTokens][table->otherTokens];
+                uint64_t counted[3] = {0, 0, 0};
+
+                entries.resize(table->size);
+
+                for (uint64_t i = 0; i < table->size; i++) {
+                    entries[i] = table->values[i].load(memory_order_relaxed);
+                    counted[decodeTablebaseEntry(entries[i]).result + 1]++;
+                }
+
+                string path = tablebaseFileName(directory, table->moverTokens, table->otherTokens);
+
+                if (!writeTablebase(path, table->moverTokens, table->otherTokens, entries.data())) {
+                    fprintf(stderr, "tbgen: cannot write %s\n", path.c_str());
+                    return 1;
+                }
+
+                MappedFile file;
+                file.open(path);
+
+                printf("%dv%d: %llu positions, %llu won, %llu drawn, %llu lost, longest %d plies, %llu bytes\n",
+                       table->moverTokens, table->otherTokens, static_cast<unsigned long long>(table->size),
+                       static_cast<unsigned long long>(counted[2]), static_cast<unsigned long long>(counted[1]),
+                       static_cast<unsigned long long>(counted[0]), longest, static_cast<unsigned long long>(file.getSize()));
+                fflush(stdout);
+            }
+        }
+    }
+
+    uint64_t failures = checkTables(directory, maxTokens);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("%s, %.1f s\n", failures == 0 ? "tables check out" : "tables do NOT check out", seconds);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Endgame tablebase generator, solves the positions
+# with few tokens left by retrograde analysis
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = tbgen
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS += -std=c++14
+
+include(../../engine/engine.pri)
+
+SOURCES += \
+        main.cpp
@@ -0,0 +1,490 @@
+#include "ai.h"
+#include "game.h"
+#include "notation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Self-play tournament, every engine setting plays every other one from the
+ * same openings, each opening once with either colour, and the games run in
+ * parallel on all cores. An engine setting is one combination of the
+ * algorithms, heuristics, depths, move times and quiescence settings given
+ * on the command line.
+ *
+ * A game is won by taking the last opposing token or by leaving the side
+ * to move without a move, as the search and the endgame tables score it,
+ * and drawn after STALEMATE_MOVES moves in a row without a capture. The
+ * report gives the wins, draws and losses of each pairing with the Elo
+ * difference and its 95% error bar, the standing of each setting against
+ * the field, the average game length, the stalemate rate and the rate of
+ * games won by leaving the other side without a move.
+ * Run with --help for the options. */
+
+struct EngineSetting {
+    bool isMinimax;
+    int heuristicIndex;
+    int plies;
+    int timeLimit; //ms per move, 0 = depth only
+    bool quiescence;
+    string name;
+};
+
+struct Opening {
+    Position position;
+    char side;
+};
+
+struct GameJob {
+    int first; //Setting playing green
+    int second; //Setting playing red
+    int opening;
+};
+
+struct GameResult {
+    double greenScore; //1 green won, 0.5 draw, 0 red won
+    int plies;
+    bool stalemate;
+    bool blocked; //Won by leaving the side to move without a move
+};
+
+// Wins, draws and losses from the point of view of one setting
+struct Tally {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    double squares = 0; //Sum of the squared game scores, for the variance
+
+    void add(double score) {
+        if (score == 1)
+            wins++;
+        else if (score == 0)
+            losses++;
+        else
+            draws++;
+        squares += score * score;
+    }
+
+    int getGames() const { return wins + draws + losses; }
+    double getScore() const { return getGames() == 0 ? 0.5 : (wins + 0.5 * draws) / getGames(); }
+};
+
+static void printUsage() {
+    fprintf(stderr,
+            "usage: tournament [options]\n"
+            "  -a, --algorithms <list>   minimax and/or alphabeta, default alphabeta\n"
+            "  -e, --heuristics <list>   0 = naive, 1 = counting, 2 = informed, default 0,1,2\n"
+            "  -d, --depths <list>       deepest search in plies, default 3\n"
+            "  -t, --times <list>        time per move in ms, 0 = no limit, default 0\n"
+            "  -q, --quiescence <list>   1 = alpha-beta plays out captures past its leaves, 0 = not, default 1\n"
+            "  -g, --games <n>           games per pairing, played in pairs with colours swapped, default 100\n"
+            "  -r, --random-plies <n>    random moves played from the start to open a game, default 4\n"
+            "  -b, --book <file>         openings, one \"<rows> <R|G>\" per line, instead of random ones\n"
+            "  -j, --concurrency <n>     games played at once, default one per core\n"
+            "      --hash <MB>           transposition table of each engine, default 4\n"
+            "      --seed <n>            seed of the random openings, default 1\n"
+            "  lists are comma separated, e.g. --depths 2,3,4\n");
+}
+
+static bool isOption(const char* arg, const char* shortName, const char* longName) {
+    return (shortName != nullptr && strcmp(arg, shortName) == 0) || strcmp(arg, longName) == 0;
+}
+
+static vector<string> splitList(const char* value) {
+    vector<string> items;
+    stringstream stream(value);
+    string item;
+
+    while (getline(stream, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+
+    return items;
+}
+
+static vector<int> parseIntList(const char* value) {
+    vector<int> numbers;
+
+    for (const string& item : splitList(value))
+        numbers.push_back(atoi(item.c_str()));
+
+    return numbers;
+}
+
+/**
+ * @brief randomOpening, plays random moves from the start position, a side that
+ *        runs out of moves or tokens ends the opening early
+ * @param plies, number of moves to play
+ * @param random, generator seeded for this opening
+ */
+
+static Opening randomOpening(int plies, mt19937_64& random) {
+    Opening opening;
+    parsePosition("start", opening.position);
+    opening.side = 'G';
+
+    Move moves[MAX_MOVES];
+
+    for (int ply = 0; ply < plies; ++ply) {
+        if (opening.position.getTokenAmount('R') == 0 || opening.position.getTokenAmount('G') == 0)
+            break;
+
+        int moveCount = opening.position.generateMoves(opening.side, moves);
+
+        if (moveCount == 0)
+            break;
+
+        opening.position = Position(opening.position.getTokens('R'), opening.position.getTokens('G'));
+        opening.position.applyMove(moves[random() % moveCount]);
+        opening.side = opening.side == 'G' ? 'R' : 'G';
+    }
+
+    return opening;
+}
+
+static bool readBook(const char* path, vector<Opening>& openings) {
+    ifstream file(path);
+
+    if (!file)
+        return false;
+
+    string line;
+
+    while (getline(file, line)) {
+        stringstream stream(line);
+        string rows;
+        string side;
+
+        if (!(stream >> rows) || rows[0] == '#')
+            continue;
+
+        Opening opening;
+        stream >> side;
+        opening.side = (side == "r" || side == "R") ? 'R' : 'G';
+
+        if (!parsePosition(rows, opening.position)) {
+            fprintf(stderr, "tournament: invalid book position %s\n", rows.c_str());
+            return false;
+        }
+
+        openings.push_back(opening);
+    }
+
+    return !openings.empty();
+}
+
+/**
+ * @brief playGame, plays one game between two engines sharing the board they search
+ * @param engines, the worker's engine of every setting, built when first needed
+ * @param board, board the engines of the worker read the position from
+ */
+
+static GameResult playGame(const GameJob& job, const vector<EngineSetting>& settings, const Opening& opening,
+                           vector<unique_ptr<AIPlayer>>& engines, Board& board, int hashSize) {
+    for (int index : {job.first, job.second}) {
+        if (!engines[index]) {
+            engines[index].reset(new AIPlayer(&board));
+            engines[index]->setHashSize(hashSize);
+            engines[index]->setTracing(false);
+        }
+
+        engines[index]->setQuiescence(settings[index].quiescence);
+
+        // every game starts cold so its result does not depend on the games the worker played before
+        engines[index]->getTranspositionTable()->clear();
+        engines[index]->getMoveOrderer()->clear();
+    }
+
+    Position position(opening.position.getTokens('R'), opening.position.getTokens('G'));
+    char side = opening.side;
+    int quietMoves = 0;
+    GameResult result = {0.5, 0, false, false};
+    Move moves[MAX_MOVES];
+
+    while (true) {
+        if (position.getTokenAmount('R') == 0 || position.getTokenAmount('G') == 0) {
+            result.greenScore = position.getTokenAmount('R') == 0 ? 1 : 0;
+            break;
+        }
+
+        if (position.generateMoves(side, moves) == 0) {
+            result.greenScore = side == 'G' ? 0 : 1;
+            result.blocked = true;
+            break;
+        }
+
+        if (quietMoves >= STALEMATE_MOVES) {
+            result.stalemate = true;
+            break;
+        }
+
+        const EngineSetting& setting = settings[side == 'G' ? job.first : job.second];
+        AIPlayer* engine = engines[side == 'G' ? job.first : job.second].get();
+
+        board.setPosition(position);
+        Move move = engine->getNextMoveFromAI(setting.plies + 1, side, setting.isMinimax, setting.heuristicIndex, setting.timeLimit);
+
+        position = Position(position.getTokens('R'), position.getTokens('G'));
+        position.applyMove(move);
+        quietMoves = move.captureCount > 0 ? 0 : quietMoves + 1;
+        result.plies++;
+        side = side == 'G' ? 'R' : 'G';
+    }
+
+    return result;
+}
+
+static double eloDifference(double score) {
+    return 400 * log10(score / (1 - score));
+}
+
+/**
+ * @brief formatElo, Elo difference of a score and the half width of its 95% interval,
+ *        from the variance of the single game scores
+ */
+
+static string formatElo(const Tally& tally) {
+    int games = tally.getGames();
+    double score = tally.getScore();
+    char text[64];
+
+    if (games == 0 || score <= 0 || score >= 1) {
+        snprintf(text, sizeof(text), "%8s", score >= 1 ? "+inf" : "-inf");
+        return text;
+    }
+
+    double variance = max(0.0, tally.squares / games - score * score);
+    double margin = 1.96 * sqrt(variance / games);
+    double low = max(score - margin, 1e-6);
+    double high = min(score + margin, 1 - 1e-6);
+
+    snprintf(text, sizeof(text), "%+8.1f +/- %-6.1f", eloDifference(score), (eloDifference(high) - eloDifference(low)) / 2);
+    return text;
+}
+
+int main(int argc, char *argv[])
+{
+    vector<string> algorithms = {"alphabeta"};
+    vector<int> heuristics = {0, 1, 2};
+    vector<int> depths = {3};
+    vector<int> times = {0};
+    vector<int> quiescence = {1};
+    int games = 100;
+    int randomPlies = 4;
+    const char* bookPath = nullptr;
+    int concurrency = max(1u, thread::hardware_concurrency());
+    int hashSize = 4;
+    unsigned long long seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if (isOption(arg, "-h", "--help")) {
+            printUsage();
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            fprintf(stderr, "tournament: %s needs a value\n", arg);
+            printUsage();
+            return 1;
+        }
+
+        const char* value = argv[++i];
+
+        if (isOption(arg, "-a", "--algorithms"))
+            algorithms = splitList(value);
+        else if (isOption(arg, "-e", "--heuristics"))
+            heuristics = parseIntList(value);
+        else if (isOption(arg, "-d", "--depths"))
+            depths = parseIntList(value);
+        else if (isOption(arg, "-t", "--times"))
+            times = parseIntList(value);
+        else if (isOption(arg, "-q", "--quiescence"))
+            quiescence = parseIntList(value);
+        else if (isOption(arg, "-g", "--games"))
+            games = atoi(value);
+        else if (isOption(arg, "-r", "--random-plies"))
+            randomPlies = atoi(value);
+        else if (isOption(arg, "-b", "--book"))
+            bookPath = value;
+        else if (isOption(arg, "-j", "--concurrency"))
+            concurrency = atoi(value);
+        else if (isOption(arg, nullptr, "--hash"))
+            hashSize = atoi(value);
+        else if (isOption(arg, nullptr, "--seed"))
+            seed = strtoull(value, nullptr, 10);
+        else {
+            fprintf(stderr, "tournament: unknown option %s\n", arg);
+            printUsage();
+            return 1;
+        }
+    }
+
+    vector<EngineSetting> settings;
+
+    for (const string& algorithm : algorithms) {
+        if (algorithm != "minimax" && algorithm != "alphabeta") {
+            fprintf(stderr, "tournament: unknown algorithm %s\n", algorithm.c_str());
+            return 1;
+        }
+
+        for (int heuristicIndex : heuristics)
+            for (int plies : depths)
+                for (int timeLimit : times)
+                    for (int extension : quiescence) {
+                        // minimax never plays out captures, one setting is enough
+                        if (algorithm == "minimax" && extension != quiescence[0])
+                            continue;
+
+                        if (heuristicIndex < 0 || heuristicIndex > 2 || plies < 1 || plies >= MAX_PLY || timeLimit < 0) {
+                            fprintf(stderr, "tournament: engine setting out of range\n");
+                            return 1;
+                        }
+
+                        EngineSetting setting = {algorithm == "minimax", heuristicIndex, plies, timeLimit, extension != 0, ""};
+                        setting.name = string(setting.isMinimax ? "mm" : "ab") + "-h" + to_string(heuristicIndex) + "-d" + to_string(plies);
+
+                        if (timeLimit > 0)
+                            setting.name += "-t" + to_string(timeLimit);
+
+                        if (!setting.isMinimax && !setting.quiescence)
+                            setting.name += "-noq";
+
+                        settings.push_back(setting);
+                    }
+    }
+
+    if (settings.size() < 2 || games < 1 || randomPlies < 0 || concurrency < 1 || hashSize < 1) {
+        fprintf(stderr, "tournament: needs two engine settings and positive limits\n");
+        return 1;
+    }
+
+    // each opening is played twice per pairing, once with either colour
+    int openingCount = (games + 1) / 2;
+    vector<Opening> book;
+    vector<Opening> openings;
+
+    if (bookPath != nullptr && !readBook(bookPath, book)) {
+        fprintf(stderr, "tournament: cannot read openings from %s\n", bookPath);
+        return 1;
+    }
+
+    for (int i = 0; i < openingCount; ++i) {
+        if (!book.empty())
+            openings.push_back(book[i % book.size()]);
+        else {
+            mt19937_64 random(seed * 0x9E3779B97F4A7C15ULL + i);
+            openings.push_back(randomOpening(randomPlies, random));
+        }
+    }
+
+    vector<GameJob> jobs;
+
+    for (int a = 0; a < static_cast<int>(settings.size()); ++a)
+        for (int b = a + 1; b < static_cast<int>(settings.size()); ++b)
+            for (int game = 0; game < games; ++game)
+                jobs.push_back(game % 2 == 0 ? GameJob{a, b, game / 2} : GameJob{b, a, game / 2});
+
+    printf("%zu settings, %zu games, %d at once\n", settings.size(), jobs.size(), concurrency);
+    fflush(stdout);
+
+    // the workers take the next game from a shared counter and write its result to its own slot
+    vector<GameResult> results(jobs.size());
+    atomic<size_t> nextJob(0);
+    atomic<size_t> finishedJobs(0);
+    vector<thread> workers;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    for (int w = 0; w < concurrency; ++w) {
+        workers.emplace_back([&]() {
+            Board board;
+            vector<unique_ptr<AIPlayer>> engines(settings.size());
+
+            for (size_t job = nextJob++; job < jobs.size(); job = nextJob++) {
+                results[job] = playGame(jobs[job], settings, openings[jobs[job].opening], engines, board, hashSize);
+
+                size_t finished = ++finishedJobs;
+
+                if (finished % 100 == 0 || finished == jobs.size())
+                    fprintf(stderr, "\r%zu/%zu games", finished, jobs.size());
+            }
+        });
+    }
+
+    for (thread& worker : workers)
+        worker.join();
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "\n");
+
+    // tallies[a][b] holds the results of a against b, the last column those of a against the field
+    size_t count = settings.size();
+    vector<vector<Tally>> tallies(count, vector<Tally>(count + 1));
+    long long totalPlies = 0;
+    int stalemates = 0;
+    int blocked = 0;
+    int greenWins = 0;
+    int redWins = 0;
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const GameJob& job = jobs[i];
+        const GameResult& result = results[i];
+
+        tallies[job.first][job.second].add(result.greenScore);
+        tallies[job.second][job.first].add(1 - result.greenScore);
+        tallies[job.first][count].add(result.greenScore);
+        tallies[job.second][count].add(1 - result.greenScore);
+
+        totalPlies += result.plies;
+        stalemates += result.stalemate;
+        blocked += result.blocked;
+        greenWins += result.greenScore == 1;
+        redWins += result.greenScore == 0;
+    }
+
+    printf("\n%-20s %-20s %6s %6s %6s %7s  %s\n", "setting", "opponent", "wins", "draws", "losses", "score", "elo");
+
+    for (size_t a = 0; a < count; ++a)
+        for (size_t b = a + 1; b < count; ++b) {
+            const Tally& tally = tallies[a][b];
+            printf("%-20s %-20s %6d %6d %6d %6.1f%%  %s\n", settings[a].name.c_str(), settings[b].name.c_str(),
+                   tally.wins, tally.draws, tally.losses, 100 * tally.getScore(), formatElo(tally).c_str());
+        }
+
+    vector<size_t> ranking(count);
+
+    for (size_t i = 0; i < count; ++i)
+        ranking[i] = i;
+
+    sort(ranking.begin(), ranking.end(), [&](size_t a, size_t b) {
+        return tallies[a][count].getScore() > tallies[b][count].getScore();
+    });
+
+    printf("\n%-20s %6s %6s %6s %7s  %s\n", "against the field", "wins", "draws", "losses", "score", "elo");
+
+    for (size_t i : ranking) {
+        const Tally& tally = tallies[i][count];
+        printf("%-20s %6d %6d %6d %6.1f%%  %s\n", settings[i].name.c_str(),
+               tally.wins, tally.draws, tally.losses, 100 * tally.getScore(), formatElo(tally).c_str());
+    }
+
+    printf("\ngames          %zu in %.1f s\n", jobs.size(), elapsed);
+    printf("average length %.1f plies\n", static_cast<double>(totalPlies) / jobs.size());
+    printf("stalemates     %.1f%%\n", 100.0 * stalemates / jobs.size());
+    printf("no move left   %.1f%%\n", 100.0 * blocked / jobs.size());
+    printf("green wins     %.1f%%\n", 100.0 * greenWins / jobs.size());
+    printf("red wins       %.1f%%\n", 100.0 * redWins / jobs.size());
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Self-play tournament between engine settings,
+# plays the games in parallel and reports Elo
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = tournament
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS += -std=c++14
+
+include(../../engine/engine.pri)
+
+SOURCES += \
+        main.cpp
@@ -0,0 +1,169 @@
+#include "transposition.h"
+
+#include <new>
+
+/* Entry data word: score in bits 0-31, best move origin 32-39, destination 40-47,
+ * depth 48-55, bound and age 56-63 */
+
+static uint64_t packEntry(int score, int bestFrom, int bestTo, int depth, uint8_t boundAndAge) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(score))
+         | static_cast<uint64_t>(static_cast<uint8_t>(bestFrom)) << 32
+         | static_cast<uint64_t>(static_cast<uint8_t>(bestTo)) << 40
+         | static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 48
+         | static_cast<uint64_t>(boundAndAge) << 56;
+}
+
+static TTEntry unpackEntry(uint64_t key, uint64_t data) {
+    TTEntry entry;
+    entry.key = key;
+    entry.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+    entry.bestFrom = static_cast<int8_t>(data >> 32);
+    entry.bestTo = static_cast<int8_t>(data >> 40);
+    entry.depth = static_cast<int8_t>(data >> 48);
+    entry.boundAndAge = static_cast<uint8_t>(data >> 56);
+    return entry;
+}
+
+TranspositionTable::TranspositionTable(int sizeMB) : buckets(nullptr), bucketMask(0), age(0)
+{
+    resize(sizeMB);
+}
+
+/**
+ * @brief TranspositionTable::resize, reallocates the table, rounded down to a power of two buckets
+ * @param sizeMB, table size in megabytes, at least 1
+ */
+
+void TranspositionTable::resize(int sizeMB) {
+    if (sizeMB < 1)
+        sizeMB = 1;
+
+    uint64_t bucketCount = 1;
+
+    while (bucketCount * 2 * sizeof(TTBucket) <= static_cast<uint64_t>(sizeMB) * 1024 * 1024)
+        bucketCount *= 2;
+
+    // over allocate by one cache line so the buckets can start on a line boundary
+    memory.reset(new char[bucketCount * sizeof(TTBucket) + alignof(TTBucket)]);
+    uintptr_t address = reinterpret_cast<uintptr_t>(memory.get());
+    address = (address + alignof(TTBucket) - 1) & ~static_cast<uintptr_t>(alignof(TTBucket) - 1);
+
+    buckets = reinterpret_cast<TTBucket*>(address);
+    bucketMask = bucketCount - 1;
+
+    for (uint64_t i = 0; i < bucketCount; ++i)
+        new (&buckets[i]) TTBucket();
+
+    clear();
+}
+
+/**
+ * @brief TranspositionTable::clear, empties the table, no search may be running
+ */
+
+void TranspositionTable::clear() {
+    for (uint64_t i = 0; i <= bucketMask; ++i) {
+        for (int j = 0; j < TT_BUCKET_SIZE; ++j) {
+            buckets[i].entries[j].check.store(0, std::memory_order_relaxed);
+            buckets[i].entries[j].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    age = 0;
+}
+
+/**
+ * @brief TranspositionTable::newSearch, ages the entries of previous searches so they get replaced first
+ */
+
+void TranspositionTable::newSearch() {
+    age = (age + 1) & 63;
+}
+
+/**
+ * @brief TranspositionTable::probe, looks up a position, safe while other threads store
+ * @param key, Zobrist key of the position
+ * @param entry, filled with the stored entry on a hit
+ * @param counters, the probe and hit counters of the calling thread
+ * @return true if the position is in the table
+ */
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry, TTCounters& counters) const {
+    const TTBucket& bucket = buckets[key & bucketMask];
+    counters.probes++;
+
+    for (int i = 0; i < TT_BUCKET_SIZE; ++i) {
+        uint64_t data = bucket.entries[i].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket.entries[i].check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) != key || unpackEntry(key, data).getBound() == BOUND_NONE)
+            continue;
+
+        entry = unpackEntry(key, data);
+        counters.hits++;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief TranspositionTable::store, saves a search result
+ *        the slot of the same position is reused, else an empty slot, else the
+ *        shallowest entry of an older search, else the shallowest entry
+ * @param key, Zobrist key of the position
+ * @param depth, remaining depth the score was searched to
+ * @param score, the score
+ * @param bound, how score relates to the true value
+ * @param best, best move found, nullptr if none
+ * @param counters, the store and collision counters of the calling thread
+ */
+
+void TranspositionTable::store(uint64_t key, int depth, int score, BoundType bound, const Move* best, TTCounters& counters) {
+    TTBucket& bucket = buckets[key & bucketMask];
+    TTSlot* replace = nullptr;
+    TTEntry replaceEntry;
+
+    for (int i = 0; i < TT_BUCKET_SIZE; ++i) {
+        TTSlot& candidate = bucket.entries[i];
+        uint64_t data = candidate.data.load(std::memory_order_relaxed);
+        TTEntry candidateEntry = unpackEntry(candidate.check.load(std::memory_order_relaxed) ^ data, data);
+
+        if (candidateEntry.key == key || candidateEntry.getBound() == BOUND_NONE) {
+            replace = &candidate;
+            replaceEntry = candidateEntry;
+            break;
+        }
+
+        // prefer entries from older searches, then shallower ones
+        bool candidateOld = candidateEntry.getAge() != age;
+        bool replaceOld = replace != nullptr && replaceEntry.getAge() != age;
+
+        if (replace == nullptr || (candidateOld && !replaceOld)
+                || (candidateOld == replaceOld && candidateEntry.depth < replaceEntry.depth)) {
+            replace = &candidate;
+            replaceEntry = candidateEntry;
+        }
+    }
+
+    if (replaceEntry.getBound() != BOUND_NONE && replaceEntry.key != key)
+        counters.collisions++;
+
+    // keep the old best move when the new result does not have one
+    int bestFrom = replaceEntry.key == key ? replaceEntry.bestFrom : -1;
+    int bestTo = replaceEntry.key == key ? replaceEntry.bestTo : -1;
+
+    if (best != nullptr) {
+        bestFrom = best->from;
+        bestTo = best->to;
+    }
+
+    uint64_t data = packEntry(score, bestFrom, bestTo, depth, static_cast<uint8_t>(bound | (age << 2)));
+    replace->data.store(data, std::memory_order_relaxed);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    counters.stores++;
+}
+
+int TranspositionTable::getSizeMB() const {
+    return static_cast<int>(((bucketMask + 1) * sizeof(TTBucket)) / (1024 * 1024));
+}
@@ -0,0 +1,82 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "move.h"
+
+enum BoundType : uint8_t {
+    BOUND_NONE,
+    BOUND_EXACT,    // score is the value of the node
+    BOUND_LOWER,    // the search failed high, the value is at least score
+    BOUND_UPPER     // the search failed low, the value is at most score
+};
+
+// A table entry as the search sees it, stored packed in a TTSlot
+struct TTEntry {
+    uint64_t key;
+    int32_t score;
+    int8_t bestFrom;
+    int8_t bestTo;
+    int8_t depth;
+    uint8_t boundAndAge;    // bound in the low 2 bits, search generation above
+
+    BoundType getBound() const { return static_cast<BoundType>(boundAndAge & 3); }
+    uint8_t getAge() const { return boundAndAge >> 2; }
+};
+
+/* Search threads share the table without locks. A slot holds the entry data
+ * in one word and key ^ data in the other, so a slot torn by two threads
+ * writing at once no longer matches its key and reads as a miss.
+ * 16 bytes, four of them fill a 64 byte cache line. */
+struct TTSlot {
+    std::atomic<uint64_t> check;    // key ^ data
+    std::atomic<uint64_t> data;     // score, best move, depth, bound and age
+};
+
+const int TT_BUCKET_SIZE = 4;
+
+struct alignas(64) TTBucket {
+    TTSlot entries[TT_BUCKET_SIZE];
+};
+
+// Kept by each search thread, the shared table itself counts nothing
+struct TTCounters {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+    uint64_t collisions = 0;
+
+    TTCounters& operator+=(const TTCounters& other) {
+        probes += other.probes;
+        hits += other.hits;
+        stores += other.stores;
+        collisions += other.collisions;
+        return *this;
+    }
+};
+
+class TranspositionTable
+{
+private:
+    std::unique_ptr<char[]> memory;
+    TTBucket* buckets;
+    uint64_t bucketMask;
+    uint8_t age;
+
+public:
+    TranspositionTable(int sizeMB = 16);
+
+    void resize(int sizeMB);
+    void clear();
+    void newSearch();
+
+    bool probe(uint64_t key, TTEntry& entry, TTCounters& counters) const;
+    void store(uint64_t key, int depth, int score, BoundType bound, const Move* best, TTCounters& counters);
+
+    int getSizeMB() const;
+};
+
+#endif // TRANSPOSITION_H
@@ -0,0 +1,88 @@
+#include "workerpool.h"
+
+WorkerPool::WorkerPool() : generation(0), running(0), quitting(false), task(nullptr), context(nullptr)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    resize(0);
+}
+
+/**
+ * @brief WorkerPool::resize, replaces the workers, the threads are only started here
+ * @param count, number of workers, 0 stops them all
+ */
+
+void WorkerPool::resize(int count) {
+    {
+        lock_guard<mutex> guard(lock);
+        quitting = true;
+    }
+    wake.notify_all();
+
+    for (thread& worker : workers)
+        worker.join();
+
+    workers.clear();
+    quitting = false;
+    workers.reserve(count);
+
+    for (int i = 0; i < count; i++)
+        workers.emplace_back(&WorkerPool::workerLoop, this, i, generation);
+}
+
+int WorkerPool::getSize() const {
+    return static_cast<int>(workers.size());
+}
+
+/**
+ * @brief WorkerPool::run, wakes every worker to call the task
+ * @param newTask, called with the context and the index of the worker
+ * @param newContext, data of the task, it has to outlive the call to wait
+ */
+
+void WorkerPool::run(Task newTask, void* newContext) {
+    if (workers.empty())
+        return;
+
+    {
+        lock_guard<mutex> guard(lock);
+        task = newTask;
+        context = newContext;
+        running = static_cast<int>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+}
+
+/**
+ * @brief WorkerPool::wait, returns once every worker has finished the last task run
+ */
+
+void WorkerPool::wait() {
+    unique_lock<mutex> guard(lock);
+    done.wait(guard, [this] { return running == 0; });
+}
+
+void WorkerPool::workerLoop(int index, uint64_t seen) {
+    unique_lock<mutex> guard(lock);
+
+    while (true) {
+        wake.wait(guard, [this, seen] { return quitting || generation != seen; });
+
+        if (quitting)
+            return;
+
+        seen = generation;
+        Task current = task;
+        void* currentContext = context;
+
+        guard.unlock();
+        current(currentContext, index);
+        guard.lock();
+
+        if (--running == 0)
+            done.notify_all();
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/* Threads started once and kept waiting between searches, so a search
+ * runs its helpers without starting a thread or allocating memory.
+ * The task is a plain function and a pointer to its data; run starts
+ * it on every worker, wait returns once all of them have returned. */
+class WorkerPool{
+public:
+    typedef void (*Task)(void* context, int worker);
+
+    WorkerPool();
+    ~WorkerPool();
+
+    // stops the workers and starts count new ones, not while a task runs
+    void resize(int count);
+    int getSize() const;
+
+    // each worker calls task(context, index) once, index from 0 to getSize() - 1
+    void run(Task task, void* context);
+    void wait();
+
+private:
+    vector<thread> workers;
+    mutex lock;
+    condition_variable wake; //Signalled when a task is given or the workers have to quit
+    condition_variable done; //Signalled by the last worker to finish its task
+    uint64_t generation; //Number of tasks given, a worker runs each one once
+    int running; //Workers still in the current task
+    bool quitting;
+    Task task;
+    void* context;
+
+    // seen is the task count when the worker starts, it waits for the next one
+    void workerLoop(int index, uint64_t seen);
+};
+
+#endif // WORKERPOOL_H
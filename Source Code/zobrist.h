@@ -0,0 +1,55 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+#include "position.h"
+
+/**
+ * Random keys for Zobrist hashing, generated at compile time with splitmix64
+ * so every build hashes a position to the same value.
+ *  token[0][sq] : red token on sq
+ *  token[1][sq] : green token on sq
+ *  redToMove    : xor'ed in when red is the side to move
+ *  heuristic[i] : xor'ed in by the search so scores of different heuristics never mix
+ *  minimax      : xor'ed in by a minimax search, its scores are not those of alpha-beta
+ *  quiescence   : xor'ed in by an alpha-beta search with the capture search past its leaves
+ */
+struct ZobristKeys {
+    uint64_t token[2][BOARD_SQUARES];
+    uint64_t redToMove;
+    uint64_t heuristic[4];
+    uint64_t minimax;
+    uint64_t quiescence;
+
+    static constexpr uint64_t splitMix(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr ZobristKeys() : token(), redToMove(0), heuristic(), minimax(0), quiescence(0) {
+        uint64_t state = 0x426F6E7A6565ULL;
+
+        for (int color = 0; color < 2; ++color)
+            for (int square = 0; square < BOARD_SQUARES; ++square)
+                token[color][square] = splitMix(state);
+
+        redToMove = splitMix(state);
+
+        for (int i = 0; i < 4; ++i)
+            heuristic[i] = splitMix(state);
+
+        minimax = splitMix(state);
+        quiescence = splitMix(state);
+    }
+};
+
+constexpr ZobristKeys ZOBRIST_KEYS{};
+
+inline uint64_t tokenKey(char player, int square) {
+    return ZOBRIST_KEYS.token[player == 'R' ? 0 : 1][square];
+}
+
+#endif // ZOBRIST_H